@@ -16,7 +16,11 @@
 #include "config.h"
 #include "uart_comm.h"
 #include "led_controller.h"
+#include "led_output_fastled.h"
+#include "led_output_task.h"
+#include "led_output_apa102.h"
 #include "i2c_encoder.h"
+#include "logger.h"
 
 // ============================================================================
 // Global Variables
@@ -42,36 +46,36 @@ void setup() {
   
   Serial.begin(UART_BAUD);
   delay(100); // Allow serial to stabilize
+  logger.begin();
   
-  Serial.println("=====================================");
-  Serial.println("MIDI Master Controller - ESP32");
-  Serial.println("Hardware: XIAO ESP32-S3");
-  Serial.println("Firmware: v" FIRMWARE_VERSION);
-  Serial.println("=====================================");
-  
-  // Initialize all modules
-  Serial.println("[MAIN] Initializing system modules...");
-  
-  // 1. Initialize UART communication first
+  // 1. Initialize UART communication first - with LOG_OUTPUT_PROTOCOL it
+  // also carries the log
   uart.begin();
-  Serial.println("[MAIN] UART communication initialized");
+  LOG_INFO("MAIN", "MIDI Master Controller - ESP32 (XIAO ESP32-S3), firmware v" FIRMWARE_VERSION);
+  LOG_INFO("MAIN", "UART communication initialized");
   
   // 2. Initialize LED controller
-  ledController.begin();
-  Serial.println("[MAIN] LED controller initialized");
+#if LED_OUTPUT_TASK
+  ledController.begin(ledOutputTask);
+#elif LED_OUTPUT_HDR
+  ledController.begin(apa102HDROutput);
+#else
+  ledController.begin(fastLEDOutput);
+#endif
+  LOG_INFO("MAIN", "LED controller initialized");
   
   // 3. Initialize I2C encoder manager
   i2cEncoders.begin();
-  Serial.println("[MAIN] I2C encoder manager initialized");
+  LOG_INFO("MAIN", "I2C encoder manager initialized");
   
   // System ready
   systemReady = true;
-  Serial.println("[MAIN] System initialization complete!");
-  Serial.printf("[MAIN] Free memory: %d bytes\n", ESP.getFreeHeap());
+  LOG_INFO("MAIN", "System initialization complete!");
+  LOG_INFO("MAIN", "Free memory: %d bytes", ESP.getFreeHeap());
   
   // Show test pattern if in test mode
   if (testMode) {
-    Serial.println("[MAIN] Entering test mode - LED patterns will cycle automatically");
+    LOG_INFO("MAIN", "Entering test mode - LED patterns will cycle automatically");
     ledController.showTestPattern();
   }
 }
@@ -83,18 +87,17 @@ void setup() {
 void loop() {
   if (!systemReady) return;
   
-  // Simple heartbeat for debugging
-  static unsigned long lastHeartbeat = 0;
-  if (millis() - lastHeartbeat > 1000) {
-    Serial.println("HEARTBEAT - ESP32 is running");
-    lastHeartbeat = millis();
-  }
-  
   // Update all modules
   uart.update();           // Process UART messages
   ledController.update();  // Update LED animations
   i2cEncoders.update();    // Read I2C encoders
   
+  // Return streaming credits once streamed pixels reach the strip
+  StreamAck streamAck;
+  if (ledController.takeStreamAck(streamAck)) {
+    uart.sendStreamAck(streamAck);
+  }
+  
   // Run test mode if enabled (Phase 1 development)
   if (testMode) {
     runTestMode();
@@ -115,47 +118,47 @@ void runTestMode() {
   if (currentTime - lastTestUpdate > 3000) {
     static int testStep = 0;
     
-    Serial.printf("[LED CONTROLLER TEST] Step %d - Time: %lu\n", testStep, currentTime);
+    LOG_DEBUG("TEST", "Step %d - Time: %lu", testStep, currentTime);
     
     switch(testStep) {
       case 0:
-        Serial.println("All LEDs OFF");
+        LOG_DEBUG("TEST", "All LEDs OFF");
         ledController.clearAll();
         break;
         
       case 1:
-        Serial.println("All LEDs RED SOLID");
+        LOG_DEBUG("TEST", "All LEDs RED SOLID");
         ledController.updateEncoderRing(0, 255, 0, 0, PATTERN_SOLID, 1.0);
         break;
         
       case 2:
-        Serial.println("All LEDs GREEN SOLID");
+        LOG_DEBUG("TEST", "All LEDs GREEN SOLID");
         ledController.updateEncoderRing(0, 0, 255, 0, PATTERN_SOLID, 1.0);
         break;
         
       case 3:
-        Serial.println("All LEDs BLUE SOLID");
+        LOG_DEBUG("TEST", "All LEDs BLUE SOLID");
         ledController.updateEncoderRing(0, 0, 0, 255, PATTERN_SOLID, 1.0);
         break;
         
       case 4:
-        Serial.println("Ring Fill Pattern");
+        LOG_DEBUG("TEST", "Ring Fill Pattern");
         ledController.updateEncoderRing(0, 255, 128, 0, PATTERN_RING_FILL, 0.7);
         break;
         
       case 5:
-        Serial.println("Pulse Pattern");
+        LOG_DEBUG("TEST", "Pulse Pattern");
         ledController.updateEncoderRing(0, 128, 0, 255, PATTERN_PULSE, 1.0);
         break;
         
       case 6:
-        Serial.println("Rainbow Pattern");
+        LOG_DEBUG("TEST", "Rainbow Pattern");
         ledController.updateEncoderRing(0, 255, 255, 255, PATTERN_RAINBOW, 1.0);
         break;
     }
     
     delay(100);
-    Serial.printf("Pattern set! Free memory: %d bytes\n", ESP.getFreeHeap());
+    LOG_DEBUG("TEST", "Pattern set! Free memory: %d bytes", ESP.getFreeHeap());
     
     testStep = (testStep + 1) % 7;
     lastTestUpdate = currentTime;
@@ -168,90 +171,179 @@ void runTestMode() {
 
 // Called when LED update message received from Pi
 void onLEDUpdateReceived(int encoderId, uint8_t r, uint8_t g, uint8_t b, LEDPattern pattern, float value) {
-  Serial.printf("[CALLBACK] LED update: encoder=%d, RGB(%d,%d,%d), pattern=%d, value=%.2f\n", 
-                encoderId, r, g, b, pattern, value);
+  // No logging - automation playback sends these in bursts; only the last
+  // update per ring before the next LED frame is shown
+  LEDRingUpdate update = {encoderId, r, g, b, pattern, value};
+  ledController.stageRingUpdate(update);
+}
+
+// Called when a batch of LED updates is received from Pi
+void onLEDBatchReceived(const LEDRingUpdate* updates, int count) {
+  // All rings in the batch change in the same LED frame
+  ledController.applyBatch(updates, count);
+}
+
+// Called when a keyframe program is uploaded (encoder_id -1 = every ring)
+void onLEDProgramReceived(int encoderId, const LEDProgram& program, bool start) {
+  int first = (encoderId < 0) ? 0 : encoderId;
+  int last = (encoderId < 0) ? NUM_ENCODERS - 1 : encoderId;
+  
+  for (int i = first; i <= last; i++) {
+    if (!ledController.loadProgram(i, program, start)) {
+      uart.sendError("LED program rejected for encoder %d", i);
+      return;
+    }
+  }
+}
+
+// Called for led_program_cmd: start / stop / retarget (encoder_id -1 = every ring)
+void onLEDProgramCommand(int encoderId, const char* command, const ProgramKeyframe& target) {
+  int first = (encoderId < 0) ? 0 : encoderId;
+  int last = (encoderId < 0) ? NUM_ENCODERS - 1 : encoderId;
+  if (last >= NUM_ENCODERS) {
+    uart.sendError("Invalid encoder_id: %d", encoderId);
+    return;
+  }
+  
+  for (int i = first; i <= last; i++) {
+    if (strcmp(command, "start") == 0) {
+      // Rings without an uploaded program are left alone when starting all
+      if (!ledController.startProgram(i) && encoderId >= 0) {
+        uart.sendError("No LED program loaded for encoder %d", i);
+      }
+    } else if (strcmp(command, "stop") == 0) {
+      ledController.stopProgram(i);
+    } else if (strcmp(command, "retarget") == 0) {
+      ledController.retargetProgram(i, target);
+    } else {
+      uart.sendError("Unknown LED program command: %s", command);
+      return;
+    }
+  }
+}
+
+// Called for each led_stream frame - rejected frames are reported in the next stream_ack
+void onLEDStreamReceived(int target, uint32_t seq, bool keyFrame, const uint8_t* ops, size_t length) {
+  ledController.applyStreamFrame(target, seq, keyFrame, ops, length);
+}
+
+// Called for each led_meter level frame (no logging - these arrive at up to 60 Hz)
+void onLEDMeterReceived(int firstEncoder, const uint8_t* levels, int count) {
+  ledController.setMeterLevels(firstEncoder, levels, count);
+}
+
+// Called for led_overlay (encoder_id -1 = every ring)
+void onLEDOverlayReceived(int encoderId, int slot, const LEDOverlay& overlay) {
+  int first = (encoderId < 0) ? 0 : encoderId;
+  int last = (encoderId < 0) ? NUM_ENCODERS - 1 : encoderId;
   
-  // Update the LED controller
-  ledController.updateEncoderRing(encoderId, r, g, b, pattern, value);
+  for (int i = first; i <= last; i++) {
+    if (!ledController.setOverlay(i, slot, overlay)) {
+      uart.sendError("LED overlay rejected for encoder %d slot %d", i, slot);
+      return;
+    }
+  }
 }
 
 // Called when system command received from Pi
-void onSystemCommandReceived(const String& command, const String& parameter) {
-  Serial.printf("[CALLBACK] System command: %s = %s\n", command.c_str(), parameter.c_str());
+void onSystemCommandReceived(const char* command, const char* parameter) {
+  LOG_DEBUG("CALLBACK", "System command: %s = %s", command, parameter);
   
-  if (command == "test_mode") {
-    testMode = (parameter == "true");
-    Serial.printf("[MAIN] Test mode %s\n", testMode ? "ENABLED" : "DISABLED");
+  if (strcmp(command, "test_mode") == 0) {
+    testMode = (strcmp(parameter, "true") == 0);
+    LOG_INFO("MAIN", "Test mode %s", testMode ? "ENABLED" : "DISABLED");
     
     if (!testMode) {
       ledController.clearAll();
     }
   }
-  else if (command == "brightness") {
-    int brightness = parameter.toInt();
+  else if (strcmp(command, "brightness") == 0) {
+    int brightness = atoi(parameter);
     if (brightness >= 0 && brightness <= 255) {
       ledController.setBrightness(brightness);
     }
   }
-  else if (command == "test_pattern") {
+  else if (strcmp(command, "test_pattern") == 0) {
     ledController.showTestPattern();
   }
-  else if (command == "clear_leds") {
+  else if (strcmp(command, "clear_leds") == 0) {
     ledController.clearAll();
   }
-  else if (command == "scan_i2c") {
+  else if (strcmp(command, "scan_i2c") == 0) {
     i2cEncoders.scanForEncoders();
   }
-  else if (command == "run_diagnostics") {
-    Serial.println("[MAIN] Running LED diagnostics...");
-    ledController.runFullDiagnostics();
+  else if (strcmp(command, "run_diagnostics") == 0) {
+    LOG_INFO("MAIN", "Running LED diagnostics...");
+    startDiagnostic(ledController.runFullDiagnostics());
   }
-  else if (command == "sequential_test") {
-    int delayMs = parameter.toInt();
+  else if (strcmp(command, "sequential_test") == 0) {
+    int delayMs = atoi(parameter);
     if (delayMs <= 0) delayMs = 200;
-    ledController.sequentialTest(delayMs);
+    startDiagnostic(ledController.sequentialTest(delayMs));
+  }
+  else if (strcmp(command, "find_led_count") == 0) {
+    startDiagnostic(ledController.findLEDCount());
+  }
+  else if (strcmp(command, "diag_cancel") == 0) {
+    ledController.cancelDiagnostics();
+    uart.sendDiagnosticStatus();
   }
-  else if (command == "find_led_count") {
-    ledController.findLEDCount();
+  else if (strcmp(command, "diag_status") == 0) {
+    uart.sendDiagnosticStatus();
+  }
+  else if (strcmp(command, "led_stats") == 0) {
+    // "reset" starts a fresh measurement window after reporting
+    uart.sendLEDStats();
+    if (strcmp(parameter, "reset") == 0) {
+      ledController.resetFrameStats();
+    }
   }
-  else if (command == "test_range") {
+  else if (strcmp(command, "test_range") == 0) {
     // Format: "start,end,r,g,b" e.g. "0,10,255,0,0"
-    int commaIndex1 = parameter.indexOf(',');
-    int commaIndex2 = parameter.indexOf(',', commaIndex1 + 1);
-    int commaIndex3 = parameter.indexOf(',', commaIndex2 + 1);
-    int commaIndex4 = parameter.indexOf(',', commaIndex3 + 1);
-    
-    if (commaIndex1 > 0 && commaIndex2 > 0 && commaIndex3 > 0 && commaIndex4 > 0) {
-      int start = parameter.substring(0, commaIndex1).toInt();
-      int end = parameter.substring(commaIndex1 + 1, commaIndex2).toInt();
-      int r = parameter.substring(commaIndex2 + 1, commaIndex3).toInt();
-      int g = parameter.substring(commaIndex3 + 1, commaIndex4).toInt();
-      int b = parameter.substring(commaIndex4 + 1).toInt();
-      
+    int start, end, r, g, b;
+    if (sscanf(parameter, "%d,%d,%d,%d,%d", &start, &end, &r, &g, &b) == 5) {
       ledController.testLEDRange(start, end, CRGB(r, g, b));
     } else {
       uart.sendError("test_range format: start,end,r,g,b");
     }
   }
-  else if (command == "test_signal_integrity") {
-    Serial.println("[MAIN] Running signal integrity test...");
-    ledController.testSignalIntegrity();
+  else if (strcmp(command, "log_level") == 0) {
+    // "error", "warn", "info", "debug" or "none"
+    uint8_t level;
+    if (Logger::parseLevel(parameter, level)) {
+      logger.setLevel(level);
+    } else {
+      uart.sendError("Unknown log level: %s", parameter);
+    }
+  }
+  else if (strcmp(command, "test_signal_integrity") == 0) {
+    LOG_INFO("MAIN", "Running signal integrity test...");
+    startDiagnostic(ledController.testSignalIntegrity());
   }
   else {
-    uart.sendError("Unknown system command: " + command);
+    uart.sendError("Unknown system command: %s", command);
+  }
+}
+
+// Report the outcome of starting a non-blocking LED diagnostic
+void startDiagnostic(bool started) {
+  if (started) {
+    uart.sendDiagnosticStatus();
+  } else {
+    uart.sendError("Diagnostic already running: %s", ledController.getDiagnosticName());
   }
 }
 
 // Called when I2C encoder changes (Phase 2)
 void onEncoderChanged(int encoderId, float value, int direction) {
-  Serial.printf("[CALLBACK] Encoder %d changed: value=%.3f, direction=%d\n", 
-                encoderId, value, direction);
+  unsigned long eventMicros = micros();
+  
+  // Update local LED ring first for immediate feedback
+  ledController.commitEncoderValue(encoderId, value, eventMicros);
+  
+  LOG_DEBUG("CALLBACK", "Encoder %d changed: value=%.3f, direction=%d",
+            encoderId, value, direction);
   
   // Send encoder update via UART
   uart.sendEncoderUpdate(encoderId, value, direction);
-  
-  // Update local LED ring for immediate feedback
-  CRGB currentColor = ledController.getEncoderColor(encoderId);
-  ledController.updateEncoderRing(encoderId, currentColor.r, currentColor.g, currentColor.b, 
-                                 PATTERN_RING_FILL, value);
 } 
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// ============================================================================
+// Host Arduino Shim
+// Just enough of the Arduino core to build the LED render pipeline on a
+// desktop compiler. Time is virtual: it only moves when a host program
+// advances it (or the firmware calls delay()), which keeps captures
+// deterministic frame by frame.
+// ============================================================================
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define PI 3.1415926535897932384626433832795
+
+// Virtual clock
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void hostAdvanceMicros(unsigned long us);
+
+// Serial goes to stderr, muted by default so benchmarks stay quiet
+class HostSerial {
+public:
+    void setEnabled(bool enable) { enabled = enable; }
+    
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    size_t print(const char* message);
+    size_t println(const char* message = "");
+    
+private:
+    bool enabled = false;
+};
+
+extern HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,58 @@
+#ifndef HOST_FASTLED_H
+#define HOST_FASTLED_H
+
+// ============================================================================
+// Host FastLED Shim
+// The pixel types and constants LEDController uses - no strip drivers.
+// ============================================================================
+
+#include <Arduino.h>
+
+struct CRGB {
+    union {
+        struct {
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+        };
+        uint8_t raw[3];
+    };
+    
+    enum HTMLColorCode {
+        Black  = 0x000000,
+        Blue   = 0x0000FF,
+        Cyan   = 0x00FFFF,
+        Green  = 0x008000,
+        Orange = 0xFFA500,
+        Purple = 0x800080,
+        Red    = 0xFF0000,
+        White  = 0xFFFFFF,
+        Yellow = 0xFFFF00
+    };
+    
+    CRGB() {}
+    CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    CRGB(uint32_t colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+    CRGB(HTMLColorCode colorcode) : CRGB((uint32_t)colorcode) {}
+};
+
+inline bool operator==(const CRGB& lhs, const CRGB& rhs) {
+    return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b;
+}
+
+inline bool operator!=(const CRGB& lhs, const CRGB& rhs) {
+    return !(lhs == rhs);
+}
+
+// Color correction / temperature presets used by config.h
+enum LEDColorCorrection {
+    TypicalLEDStrip = 0xFFB0F0,
+    UncorrectedColor = 0xFFFFFF
+};
+
+enum ColorTemperature {
+    Tungsten40W = 0xFFC58F,
+    UncorrectedTemperature = 0xFFFFFF
+};
+
+#endif // HOST_FASTLED_H
@@ -0,0 +1,69 @@
+#include "capture_output.h"
+
+CaptureOutput::CaptureOutput()
+    : leds(nullptr), ledCount(0), brightness(255), capturePixels(true), totalWireBytes(0) {
+}
+
+void CaptureOutput::begin(CRGB* ledBuffer, int count) {
+    leds = ledBuffer;
+    ledCount = count;
+    reset();
+}
+
+void CaptureOutput::reset() {
+    frames.clear();
+    totalWireBytes = 0;
+    lastShownBrightness = brightness;
+    colorTableBuild(colorTable, LED_COLOR_CORRECTION, LED_COLOR_TEMPERATURE, brightness);
+    for (int i = 0; i < LED_STRIP_COUNT; i++) {
+        stripPushes[i] = 0;
+    }
+}
+
+bool CaptureOutput::show(uint32_t stripMask) {
+    CapturedFrame frame;
+    frame.timestampUs = micros();
+    frame.brightness = brightness;  // Already power limited by LEDController
+    
+    // A brightness change affects every strip (same rule as FastLEDOutput)
+    if (frame.brightness != lastShownBrightness) {
+        stripMask = LED_ALL_STRIPS;
+        lastShownBrightness = frame.brightness;
+        colorTableBuild(colorTable, LED_COLOR_CORRECTION, LED_COLOR_TEMPERATURE, frame.brightness);
+    }
+    
+    // APA102: 4-byte start frame, 4 bytes per LED, end frame of n/32+1 words
+    frame.stripMask = 0;
+    frame.wireBytes = 0;
+    for (int i = 0; i < LED_STRIP_COUNT; i++) {
+        if (!(stripMask & (1UL << i))) continue;
+        
+        int count = STRIP_LAYOUT[i].count;
+        frame.stripMask |= 1UL << i;
+        frame.wireBytes += 4 + 4 * count + 4 * (count / 32 + 1);
+        stripPushes[i]++;
+    }
+    totalWireBytes += frame.wireBytes;
+    
+    if (capturePixels) {
+        frame.pixels.resize(ledCount);
+        for (int i = 0; i < ledCount; i++) {
+            for (int c = 0; c < 3; c++) {
+                frame.pixels[i].raw[c] = colorTable.channel[c][leds[i].raw[c]];
+            }
+        }
+    }
+    
+    frames.push_back(frame);
+    return true;
+}
+
+void CaptureOutput::writeFrames(FILE* out) const {
+    for (const CapturedFrame& frame : frames) {
+        fprintf(out, "%lu %X %u %u", frame.timestampUs, frame.stripMask, frame.wireBytes, frame.brightness);
+        for (const CRGB& pixel : frame.pixels) {
+            fprintf(out, " %02X%02X%02X", pixel.r, pixel.g, pixel.b);
+        }
+        fprintf(out, "\n");
+    }
+}
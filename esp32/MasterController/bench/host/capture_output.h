@@ -0,0 +1,81 @@
+#ifndef CAPTURE_OUTPUT_H
+#define CAPTURE_OUTPUT_H
+
+#include <vector>
+#include "led_output.h"
+#include "config.h"
+#include "ring_layout.h"
+#include "led_scaling.h"
+
+// ============================================================================
+// Capture Output Backend (host only)
+// Records every frame LEDController pushes: timestamp, APA102 wire bytes and
+// the pixels as the strip would receive them after color correction and
+// brightness (modelled on FastLED's show()). Power limiting is already
+// applied by LEDController through setBrightness().
+// ============================================================================
+
+// Complete output lookup: value -> corrected, scaled value per channel, as
+// FastLED's show() would output it. Rebuilt only when brightness changes.
+struct ColorTable {
+    uint8_t channel[3][256];
+    uint8_t brightness;
+};
+
+inline void colorTableBuild(ColorTable& table, uint32_t correction, uint32_t temperature, uint8_t brightness) {
+    for (int c = 0; c < 3; c++) {
+        uint32_t scale = colorChannelScale(correction, temperature, c, brightness);
+        for (int v = 0; v < 256; v++) {
+            table.channel[c][v] = (uint8_t)((v * scale) >> 8);
+        }
+    }
+    table.brightness = brightness;
+}
+
+struct CapturedFrame {
+    unsigned long timestampUs;   // Virtual micros() at show()
+    uint32_t stripMask;          // Strips actually pushed
+    uint32_t wireBytes;          // APA102 bytes on the wire, incl. start/end frames
+    uint8_t brightness;          // Brightness after power limiting
+    std::vector<CRGB> pixels;    // Output pixels (empty if pixel capture is off)
+};
+
+class CaptureOutput : public LEDOutput {
+public:
+    CaptureOutput();
+    
+    // LEDOutput
+    void begin(CRGB* leds, int count) override;
+    bool show(uint32_t stripMask = LED_ALL_STRIPS) override;
+    void setBrightness(uint8_t value) override { brightness = value; }
+    uint8_t getBrightness() const override { return brightness; }
+    int getStripCount() const override { return LED_STRIP_COUNT; }
+    const char* getName() const override { return "capture"; }
+    
+    // Capture control
+    void setCapturePixels(bool enable) { capturePixels = enable; }
+    void reset();
+    
+    // Results
+    const std::vector<CapturedFrame>& getFrames() const { return frames; }
+    unsigned long getFrameCount() const { return frames.size(); }
+    unsigned long long getTotalWireBytes() const { return totalWireBytes; }
+    unsigned long getStripPushes(int strip) const { return stripPushes[strip]; }
+    
+    // One line per frame: "<us> <mask> <bytes> <brightness> RRGGBB ..." for golden diffs
+    void writeFrames(FILE* out) const;
+    
+private:
+    CRGB* leds;
+    int ledCount;
+    uint8_t brightness;
+    bool capturePixels;
+    
+    std::vector<CapturedFrame> frames;
+    unsigned long long totalWireBytes;
+    unsigned long stripPushes[LED_STRIP_COUNT];
+    uint8_t lastShownBrightness;
+    ColorTable colorTable;          // Correction x temperature x brightness
+};
+
+#endif // CAPTURE_OUTPUT_H
@@ -0,0 +1,45 @@
+#include <Arduino.h>
+
+HostSerial Serial;
+
+static unsigned long hostMicros = 0;
+
+unsigned long millis() {
+    return hostMicros / 1000;
+}
+
+unsigned long micros() {
+    return hostMicros;
+}
+
+void delay(unsigned long ms) {
+    hostMicros += ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us) {
+    hostMicros += us;
+}
+
+void hostAdvanceMicros(unsigned long us) {
+    hostMicros += us;
+}
+
+size_t HostSerial::printf(const char* format, ...) {
+    if (!enabled) return 0;
+    
+    va_list args;
+    va_start(args, format);
+    int written = vfprintf(stderr, format, args);
+    va_end(args);
+    return written > 0 ? written : 0;
+}
+
+size_t HostSerial::print(const char* message) {
+    if (!enabled) return 0;
+    return fputs(message, stderr) >= 0 ? strlen(message) : 0;
+}
+
+size_t HostSerial::println(const char* message) {
+    if (!enabled) return 0;
+    return print(message) + print("\n");
+}
@@ -0,0 +1,270 @@
+// ============================================================================
+// Pattern Kernel Microbenchmark (host)
+// Compares the original float pulse/rainbow/blend kernels against the
+// integer kernels in pattern_kernels.h and checks that the integer output
+// stays within 1 LSB of the float output: pulse per channel for every 16-bit
+// phase and channel value, rainbow per hue for every phase at ring sizes 1-72.
+//
+// Build & run from this directory:
+//   g++ -O2 -std=c++11 -I.. pattern_kernels_bench.cpp -o pattern_kernels_bench
+//   ./pattern_kernels_bench
+//
+// Cycle counts come from the host TSC, so only the ratio between kernels
+// carries over to the ESP32-S3.
+// ============================================================================
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include "pattern_kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t readCycles() { return __rdtsc(); }
+#else
+static inline uint64_t readCycles() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+struct Pixel {
+    uint8_t r, g, b;
+};
+
+static const int LEDS_PER_RING = 28;
+static const int BENCH_FRAMES = 2000;
+static const uint16_t BENCH_PHASE_STEP = 1311; // 0.02 cycles per frame
+
+// Identity ring map - LEDs laid out contiguously
+static uint16_t identityMap[448];
+
+// ----------------------------------------------------------------------------
+// Reference kernels (the float implementation the integer kernels replace)
+// ----------------------------------------------------------------------------
+
+static uint8_t refScale8(uint8_t i, uint8_t scale) {
+    return (uint8_t)(((uint16_t)i * (1 + scale)) >> 8);
+}
+
+// FastLED hsv2rgb_rainbow() at full saturation and value
+static Pixel refHueToRgb(uint8_t hue) {
+    uint8_t offset8 = (hue & 0x1F) << 3;
+    uint8_t third = refScale8(offset8, 85);
+    uint8_t twothirds = refScale8(offset8, 170);
+    Pixel p;
+    
+    switch (hue >> 5) {
+        case 0:  p.r = 255 - third; p.g = third;             p.b = 0;                 break;
+        case 1:  p.r = 171;         p.g = 85 + third;        p.b = 0;                 break;
+        case 2:  p.r = 171 - twothirds; p.g = 170 + third;   p.b = 0;                 break;
+        case 3:  p.r = 0;           p.g = 255 - third;       p.b = third;             break;
+        case 4:  p.r = 0;           p.g = 171 - twothirds;   p.b = 85 + twothirds;    break;
+        case 5:  p.r = third;       p.g = 0;                 p.b = 255 - third;       break;
+        case 6:  p.r = 85 + third;  p.g = 0;                 p.b = 171 - third;       break;
+        default: p.r = 170 + third; p.g = 0;                 p.b = 85 - third;        break;
+    }
+    return p;
+}
+
+// getPulseValue() (double sin) and scaleBrightness() (clamp, float multiply)
+static void refFillPulse(Pixel* out, int count, Pixel color, float phase) {
+    float pulse = 0.1 + 0.9 * (sin(phase * 2 * M_PI) + 1) / 2;
+    if (pulse > 1.0f) pulse = 1.0f;
+    Pixel c;
+    c.r = (uint8_t)(color.r * pulse);
+    c.g = (uint8_t)(color.g * pulse);
+    c.b = (uint8_t)(color.b * pulse);
+    for (int i = 0; i < count; i++) out[i] = c;
+}
+
+static uint8_t refRainbowHue(float phase, int i, int count) {
+    float p = phase + (float)i / count;
+    while (p > 1.0f) p -= 1.0f;
+    return (uint8_t)(p * 255);
+}
+
+static void refFillRainbow(Pixel* out, int count, float phase) {
+    for (int i = 0; i < count; i++) {
+        out[i] = refHueToRgb(refRainbowHue(phase, i, count));
+    }
+}
+
+// LEDController::blendColors() before the packed integer version
+static Pixel refBlend(Pixel color1, Pixel color2, float ratio) {
+    Pixel p;
+    p.r = (uint8_t)(color1.r * (1 - ratio) + color2.r * ratio);
+    p.g = (uint8_t)(color1.g * (1 - ratio) + color2.g * ratio);
+    p.b = (uint8_t)(color1.b * (1 - ratio) + color2.b * ratio);
+    return p;
+}
+
+static void refCrossfade(Pixel* strip, const Pixel* from, int count, float ratio) {
+    for (int i = 0; i < count; i++) {
+        strip[i] = refBlend(from[i], strip[i], ratio);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Equivalence checks
+// ----------------------------------------------------------------------------
+
+static int maxChannelDiff(const Pixel* a, const Pixel* b, int count) {
+    int worst = 0;
+    for (int i = 0; i < count; i++) {
+        worst = std::max(worst, abs(a[i].r - b[i].r));
+        worst = std::max(worst, abs(a[i].g - b[i].g));
+        worst = std::max(worst, abs(a[i].b - b[i].b));
+    }
+    return worst;
+}
+
+static bool isRainbowHue(const Pixel& p, int hue) {
+    hue &= 0xFF;
+    return p.r == RAINBOW_TABLE[hue][0] && p.g == RAINBOW_TABLE[hue][1] && p.b == RAINBOW_TABLE[hue][2];
+}
+
+static const int TOLERANCE = 1;
+
+static bool checkEquivalence() {
+    static const int MAX_RING = 72;
+    Pixel ref[MAX_RING], fixed[MAX_RING];
+    int tableErrors = 0, pulseWorst = 0, blendWorst = 0;
+    unsigned long pulseMismatches = 0, pulseChecked = 0, pulseFailures = 0;
+    unsigned long rainbowMismatches = 0, rainbowChecked = 0, rainbowFailures = 0;
+    
+    for (int hue = 0; hue < 256; hue++) {
+        Pixel p = refHueToRgb(hue);
+        if (p.r != RAINBOW_TABLE[hue][0] || p.g != RAINBOW_TABLE[hue][1] || p.b != RAINBOW_TABLE[hue][2]) {
+            tableErrors++;
+        }
+    }
+    
+    for (uint32_t phase = 0; phase < 65536; phase++) {
+        float floatPhase = phase / 65536.0f;
+        
+        // Every channel value, three per pixel
+        for (int v = 0; v < 256; v += 3) {
+            Pixel color = { (uint8_t)v, (uint8_t)std::min(v + 1, 255), (uint8_t)std::min(v + 2, 255) };
+            refFillPulse(ref, 1, color, floatPhase);
+            patternFillPulse(fixed, 1, color, (uint16_t)phase);
+            int diff = maxChannelDiff(ref, fixed, 1);
+            pulseWorst = std::max(pulseWorst, diff);
+            pulseMismatches += diff != 0;
+            pulseFailures += diff > TOLERANCE;
+            pulseChecked++;
+        }
+        
+        for (int count = 1; count <= MAX_RING; count++) {
+            patternFillRainbow(fixed, identityMap, count, (uint16_t)phase);
+            for (int i = 0; i < count; i++) {
+                int hue = refRainbowHue(floatPhase, i, count);
+                if (isRainbowHue(fixed[i], hue)) continue;
+                rainbowMismatches++;
+                bool withinTolerance = false;
+                for (int d = 1; d <= TOLERANCE; d++) {
+                    withinTolerance |= isRainbowHue(fixed[i], hue - d) || isRainbowHue(fixed[i], hue + d);
+                }
+                rainbowFailures += !withinTolerance;
+            }
+            rainbowChecked += count;
+        }
+    }
+    
+    for (int weight = 0; weight <= 256; weight++) {
+        for (int v = 0; v < 256; v += 5) {
+            Pixel from = { (uint8_t)v, (uint8_t)(255 - v), 255 };
+            Pixel to = { (uint8_t)(255 - v), (uint8_t)v, 0 };
+            Pixel a = refBlend(from, to, weight / 256.0f);
+            Pixel b = patternBlend(from, to, (uint16_t)weight);
+            blendWorst = std::max(blendWorst, maxChannelDiff(&a, &b, 1));
+        }
+    }
+    
+    printf("Rainbow table mismatches: %d/256\n", tableErrors);
+    printf("Pixels differing from float kernels: pulse=%lu/%lu rainbow=%lu/%lu\n",
+           pulseMismatches, pulseChecked, rainbowMismatches, rainbowChecked);
+    printf("Outside +/-%d LSB: pulse=%lu rainbow=%lu\n", TOLERANCE, pulseFailures, rainbowFailures);
+    printf("Max channel difference vs float kernels: pulse=%d blend=%d\n\n", pulseWorst, blendWorst);
+    
+    return tableErrors == 0 && pulseFailures == 0 && rainbowFailures == 0;
+}
+
+// ----------------------------------------------------------------------------
+// Timing
+// ----------------------------------------------------------------------------
+
+static volatile uint8_t sink;
+
+template <typename RenderFrame>
+static double cyclesPerFrame(Pixel* strip, int totalLeds, RenderFrame render) {
+    uint64_t start = readCycles();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        render(frame);
+        sink = strip[frame % totalLeds].r;
+    }
+    return (double)(readCycles() - start) / BENCH_FRAMES;
+}
+
+static void benchLedCount(int totalLeds) {
+    Pixel* strip = new Pixel[totalLeds];
+    Pixel color = { 200, 100, 255 };
+    int rings = totalLeds / LEDS_PER_RING;
+    int ringLeds = LEDS_PER_RING;
+    if (rings == 0 || totalLeds % LEDS_PER_RING != 0) {
+        rings = 1;
+        ringLeds = totalLeds;
+    }
+    
+    double pulseFloat = cyclesPerFrame(strip, totalLeds, [&](int frame) {
+        for (int r = 0; r < rings; r++)
+            refFillPulse(strip + r * ringLeds, ringLeds, color, fmodf(frame * 0.02f, 1.0f));
+    });
+    double pulseInt = cyclesPerFrame(strip, totalLeds, [&](int frame) {
+        for (int r = 0; r < rings; r++)
+            patternFillPulse(strip + r * ringLeds, ringLeds, color, (uint16_t)(frame * BENCH_PHASE_STEP));
+    });
+    double rainbowFloat = cyclesPerFrame(strip, totalLeds, [&](int frame) {
+        for (int r = 0; r < rings; r++)
+            refFillRainbow(strip + r * ringLeds, ringLeds, fmodf(frame * 0.02f, 1.0f));
+    });
+    double rainbowInt = cyclesPerFrame(strip, totalLeds, [&](int frame) {
+        for (int r = 0; r < rings; r++)
+            patternFillRainbow(strip + r * ringLeds, identityMap, ringLeds, (uint16_t)(frame * BENCH_PHASE_STEP));
+    });
+    
+    // Crossfade over the whole frame, from a fixed snapshot
+    Pixel* from = new Pixel[totalLeds];
+    for (int i = 0; i < totalLeds; i++) from[i] = refHueToRgb((uint8_t)i);
+    double blendFloat = cyclesPerFrame(strip, totalLeds, [&](int frame) {
+        refCrossfade(strip, from, totalLeds, (frame & 0xFF) / 256.0f);
+    });
+    double blendInt = cyclesPerFrame(strip, totalLeds, [&](int frame) {
+        patternCrossfade(strip, identityMap, totalLeds, from, (uint16_t)(frame & 0xFF));
+    });
+    
+    printf("%4d LEDs (%2d x %2d)  pulse: %9.0f -> %8.0f (%5.1fx)  rainbow: %9.0f -> %8.0f (%5.1fx)"
+           "  crossfade: %9.0f -> %8.0f (%5.1fx)\n",
+           totalLeds, rings, ringLeds,
+           pulseFloat, pulseInt, pulseFloat / pulseInt,
+           rainbowFloat, rainbowInt, rainbowFloat / rainbowInt,
+           blendFloat, blendInt, blendFloat / blendInt);
+    
+    delete[] from;
+    delete[] strip;
+}
+
+int main() {
+    for (int i = 0; i < 448; i++) identityMap[i] = i;
+    
+    bool equivalent = checkEquivalence();
+    
+    printf("Cycles per frame, float -> integer kernels:\n");
+    benchLedCount(72);
+    benchLedCount(224);
+    benchLedCount(448);
+    return equivalent ? 0 : 1;
+}
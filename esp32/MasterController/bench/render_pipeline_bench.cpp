@@ -0,0 +1,167 @@
+// ============================================================================
+// LED Render Pipeline Benchmark (host)
+// Runs the real LEDController against the capture output backend on a
+// virtual clock and reports frames pushed, bytes on the wire and the host
+// time per pushed frame (update() passes that pushed one) for a few typical
+// workloads, with the worst frame compared against the interactive frame
+// budget.
+//
+// Build & run from this directory:
+//   g++ -O2 -std=gnu++11 -Ihost -I.. -o render_pipeline_bench
+//       render_pipeline_bench.cpp host/host_arduino.cpp
+//       host/capture_output.cpp ../led_controller.cpp ../logger.cpp
+//   ./render_pipeline_bench [--dump <prefix>]
+//
+// Add -DLED_LAYOUT=LED_LAYOUT_16x28 to benchmark the full 448-LED panel.
+//
+// --dump writes every captured frame of each scenario to
+// <prefix>_<scenario>.txt so renders can be diffed against golden files.
+// ============================================================================
+
+#include <Arduino.h>
+#include <chrono>
+#include <string>
+#include "led_controller.h"
+#include "capture_output.h"
+
+static const unsigned long SCENARIO_DURATION_US = 5000000; // 5 s of device time
+static const unsigned long LOOP_STEP_US = MAIN_LOOP_DELAY_MS * 1000;
+
+static CaptureOutput capture;
+
+struct Scenario {
+    const char* name;
+    void (*setup)();
+    void (*tick)(unsigned long elapsedUs); // Called once per loop iteration
+};
+
+static void setupAllRings(uint8_t r, uint8_t g, uint8_t b, LEDPattern pattern, float value) {
+    for (int i = 0; i < NUM_ENCODERS; i++) {
+        ledController.updateEncoderRing(i, r, g, b, pattern, value);
+    }
+}
+
+static void setupStaticFill() {
+    setupAllRings(255, 128, 0, PATTERN_RING_FILL, 0.5);
+}
+
+static void setupPulse() {
+    setupAllRings(128, 0, 255, PATTERN_PULSE, 1.0);
+}
+
+static void setupRainbow() {
+    setupAllRings(255, 255, 255, PATTERN_RAINBOW, 1.0);
+}
+
+static void setupEncoderSweep() {
+    setupAllRings(0, 255, 128, PATTERN_RING_FILL, 0.0);
+}
+
+static void setupOverlays() {
+    // Every ring composited every frame: animated base + marker + range
+    setupAllRings(255, 255, 255, PATTERN_RAINBOW, 1.0);
+    LEDOverlay marker = {OVERLAY_MARKER, 255, 255, 255, 255, 40000, 0};
+    LEDOverlay range = {OVERLAY_RANGE, 0, 0, 255, 128, 16384, 49152};
+    for (int i = 0; i < NUM_ENCODERS; i++) {
+        ledController.setOverlay(i, 0, range);
+        ledController.setOverlay(i, 1, marker);
+    }
+}
+
+static void tickNone(unsigned long) {
+}
+
+static void tickCrossfade(unsigned long elapsedUs) {
+    // Every ring swaps look every 250 ms, so most frames carry a crossfade
+    if (elapsedUs % 250000 == 0) {
+        bool odd = (elapsedUs / 250000) & 1;
+        setupAllRings(odd ? 255 : 0, 128, odd ? 0 : 255, odd ? PATTERN_SOLID : PATTERN_RING_FILL, 0.5);
+    }
+}
+
+static void tickEncoderSweep(unsigned long elapsedUs) {
+    // One encoder detent every 10 ms, sweeping the full range once per second
+    if (elapsedUs % 10000 == 0) {
+        float value = (float)(elapsedUs % 1000000) / 1000000.0f;
+        ledController.commitEncoderValue(0, value, micros());
+    }
+}
+
+static const Scenario scenarios[] = {
+    { "static_fill",   setupStaticFill,   tickNone },
+    { "pulse",         setupPulse,        tickNone },
+    { "rainbow",       setupRainbow,      tickNone },
+    { "encoder_sweep", setupEncoderSweep, tickEncoderSweep },
+    { "crossfade",     setupStaticFill,   tickCrossfade },
+    { "overlays",      setupOverlays,     tickNone },
+};
+
+static void runScenario(const Scenario& scenario, const char* dumpPrefix) {
+    ledController.clearAll();
+    scenario.setup();
+    capture.reset();
+    ledController.resetEncoderLatency();
+    
+    // Only loop passes that pushed a frame count towards the frame cost
+    double frameNs = 0;
+    double worstFrameNs = 0;
+    for (unsigned long elapsed = 0; elapsed < SCENARIO_DURATION_US; elapsed += LOOP_STEP_US) {
+        unsigned long framesBefore = capture.getFrameCount();
+        
+        auto start = std::chrono::steady_clock::now();
+        scenario.tick(elapsed);
+        ledController.update();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        
+        if (capture.getFrameCount() != framesBefore) {
+            frameNs += ns;
+            if (ns > worstFrameNs) worstFrameNs = ns;
+        }
+        hostAdvanceMicros(LOOP_STEP_US);
+    }
+    
+    unsigned long frames = capture.getFrameCount();
+    double seconds = SCENARIO_DURATION_US / 1e6;
+    printf("%-14s frames=%5lu (%6.1f fps)  wire=%8.1f KB/s  host=%8.0f ns/frame  worst=%6.1f us (%5.2f%% of budget)  latency avg/max=%lu/%lu us\n",
+           scenario.name, frames, frames / seconds,
+           capture.getTotalWireBytes() / 1024.0 / seconds,
+           frames ? frameNs / frames : 0.0,
+           worstFrameNs / 1000.0, worstFrameNs / 10.0 / LED_FRAME_US_INTERACTIVE,
+           ledController.getEncoderLatencyAvgUs(), ledController.getEncoderLatencyMaxUs());
+    
+    if (LED_STRIP_COUNT > 1) {
+        printf("%-14s strip pushes:", "");
+        for (int i = 0; i < LED_STRIP_COUNT; i++) {
+            printf(" [%d]=%lu", i, capture.getStripPushes(i));
+        }
+        printf("\n");
+    }
+    
+    if (dumpPrefix) {
+        std::string path = std::string(dumpPrefix) + "_" + scenario.name + ".txt";
+        FILE* out = fopen(path.c_str(), "w");
+        if (out) {
+            capture.writeFrames(out);
+            fclose(out);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* dumpPrefix = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+            dumpPrefix = argv[++i];
+        }
+    }
+    
+    capture.setCapturePixels(dumpPrefix != nullptr);
+    ledController.begin(capture);
+    
+    printf("Render pipeline, %d rings / %d LEDs, %.0f s per scenario, frame budget %d us:\n",
+           NUM_ENCODERS, TOTAL_LEDS, SCENARIO_DURATION_US / 1e6, LED_FRAME_US_INTERACTIVE);
+    for (const Scenario& scenario : scenarios) {
+        runScenario(scenario, dumpPrefix);
+    }
+    return 0;
+}
@@ -0,0 +1,246 @@
+// ============================================================================
+// UART Binary Frame Benchmark (host)
+// Compares bytes on the wire for the hot Pi link messages as JSON lines and
+// as binary frames (uart_binary.h), and checks the frame format: CRC check
+// value, COBS round trips around the 254-byte block edge, corrupted frames
+// rejected, and frames recovered through LineFramer with a 0x00 delimiter.
+//
+// Build & run from this directory:
+//   g++ -O2 -std=c++11 -I.. uart_binary_bench.cpp -o uart_binary_bench
+//   ./uart_binary_bench
+//
+// JSON sizes are the lines UARTComm produces / the Pi sends today, CRLF
+// included; binary sizes include both 0x00 delimiters.
+// Add -DLED_LAYOUT=LED_LAYOUT_16x28 for the 16-ring batch and meter sizes.
+// ============================================================================
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include "config.h"
+#include "uart_framer.h"
+#include "uart_binary.h"
+
+struct VectorSink {
+    std::vector<uint8_t> bytes;
+    size_t write(const uint8_t* data, size_t length) {
+        bytes.insert(bytes.end(), data, data + length);
+        return length;
+    }
+};
+
+typedef BinaryFrameWriter<VectorSink> Writer;
+
+// Frame body without delimiters, as LineFramer hands it over
+static std::vector<uint8_t> frameBody(const VectorSink& sink) {
+    return std::vector<uint8_t>(sink.bytes.begin() + 1, sink.bytes.end() - 1);
+}
+
+static bool roundTrip(const std::vector<uint8_t>& data) {
+    VectorSink sink;
+    Writer writer(sink);
+    writer.begin(data.empty() ? BIN_MSG_JSON : data[0]);
+    if (data.size() > 1) writer.put(data.data() + 1, data.size() - 1);
+    size_t written = writer.end();
+
+    if (written != sink.bytes.size() || sink.bytes.front() != 0 || sink.bytes.back() != 0) return false;
+    std::vector<uint8_t> body = frameBody(sink);
+    if (memchr(body.data(), 0, body.size()) != nullptr) return false;
+
+    std::vector<uint8_t> out(body.size());
+    uint8_t type;
+    const uint8_t* payload;
+    size_t payloadLength;
+    if (!binFrameDecode(body.data(), body.size(), out.data(), type, payload, payloadLength)) return false;
+
+    std::vector<uint8_t> expected = data.empty() ? std::vector<uint8_t>(1, BIN_MSG_JSON) : data;
+    return type == expected[0] && payloadLength == expected.size() - 1 &&
+           memcmp(payload, expected.data() + 1, payloadLength) == 0;
+}
+
+static bool checkFormat() {
+    bool ok = true;
+
+    const char* check = "123456789";
+    uint16_t crc = binCrc16((const uint8_t*)check, 9);
+    printf("CRC-16/CCITT-FALSE(\"123456789\") = 0x%04X: %s\n", crc, crc == 0x29B1 ? "ok" : "FAILED");
+    ok = ok && crc == 0x29B1;
+
+    // Lengths around the COBS block size, all-zero, zero-free and random data
+    int failures = 0;
+    srand(1);
+    const size_t lengths[] = {1, 2, 3, 252, 253, 254, 255, 256, 507, 508, 509, 1400};
+    for (size_t length : lengths) {
+        for (int fill = 0; fill < 3; fill++) {
+            std::vector<uint8_t> data(length);
+            for (size_t i = 0; i < length; i++) {
+                data[i] = fill == 0 ? 0 : fill == 1 ? (uint8_t)(1 + i % 255) : (uint8_t)rand();
+            }
+            if (!roundTrip(data)) failures++;
+        }
+    }
+    printf("COBS round trips: %s\n", failures == 0 ? "ok" : "FAILED");
+    ok = ok && failures == 0;
+
+    // Single-byte corruption anywhere in an encoder frame must be caught
+    VectorSink sink;
+    Writer writer(sink);
+    writer.begin(BIN_MSG_ENCODER);
+    writer.put(3);
+    writer.put16(0x8000);
+    writer.put(1);
+    writer.put16(0x1234);
+    writer.end();
+    std::vector<uint8_t> body = frameBody(sink);
+    int accepted = 0, trials = 0;
+    for (size_t i = 0; i < body.size(); i++) {
+        for (int bit = 0; bit < 8; bit++) {
+            std::vector<uint8_t> bad = body;
+            bad[i] ^= (uint8_t)(1 << bit);
+            if (bad[i] == 0) continue;  // Would split the frame at the framer
+            std::vector<uint8_t> out(bad.size());
+            uint8_t type;
+            const uint8_t* payload;
+            size_t payloadLength;
+            trials++;
+            if (binFrameDecode(bad.data(), bad.size(), out.data(), type, payload, payloadLength)) accepted++;
+        }
+    }
+    printf("Corrupted encoder frames accepted: %d of %d: %s\n", accepted, trials, accepted == 0 ? "ok" : "FAILED");
+    ok = ok && accepted == 0;
+    return ok;
+}
+
+static bool checkFramer() {
+    // Stray text, two frames and a JSON line between delimiters, in 5-byte reads
+    VectorSink sink;
+    const char* stray = "[DEBUG] stray log line\n";
+    sink.write((const uint8_t*)stray, strlen(stray));
+    Writer writer(sink);
+    for (int i = 0; i < 2; i++) {
+        writer.begin(BIN_MSG_LED_METER);
+        writer.put(0);
+        for (int ring = 0; ring < NUM_ENCODERS; ring++) writer.put((uint8_t)(ring * 16 * i));
+        writer.end();
+    }
+    const char* json = "{\"type\":\"protocol\",\"framing\":\"json\"}";
+    sink.write((const uint8_t*)json, strlen(json));
+    sink.write((const uint8_t*)"", 1);
+
+    LineFramer<UART_BUFFER_SIZE> framer;
+    framer.setDelimiter(BIN_FRAME_DELIMITER);
+    int frames = 0, rejected = 0, jsonLines = 0;
+    uint8_t out[UART_BUFFER_SIZE];
+    for (size_t pos = 0; pos < sink.bytes.size(); pos += 5) {
+        size_t space;
+        char* dst = framer.writeBuffer(space);
+        size_t count = std::min(std::min((size_t)5, space), sink.bytes.size() - pos);
+        memcpy(dst, sink.bytes.data() + pos, count);
+        framer.commit(count);
+
+        const char* line;
+        size_t length;
+        while (framer.nextLine(line, length)) {
+            uint8_t type;
+            const uint8_t* payload;
+            size_t payloadLength;
+            if (binFrameDecode((const uint8_t*)line, length, out, type, payload, payloadLength)) {
+                if (type == BIN_MSG_LED_METER && payloadLength == 1 + NUM_ENCODERS) frames++;
+            } else if (line[0] == '{') {
+                jsonLines++;
+            } else {
+                rejected++;
+            }
+        }
+    }
+    bool ok = frames == 2 && rejected == 1 && jsonLines == 1;
+    printf("Framer with 0x00 delimiter: %d frames, %d stray rejected, %d JSON line: %s\n",
+           frames, rejected, jsonLines, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+static void report(const char* name, size_t jsonBytes, size_t binaryBytes) {
+    printf("%-28s %5zu B JSON -> %4zu B binary (%4.1fx)\n", name, jsonBytes, binaryBytes,
+           (double)jsonBytes / binaryBytes);
+}
+
+static void compareSizes() {
+    char line[4096];
+    printf("\n");
+
+    // ESP32 -> Pi
+    snprintf(line, sizeof(line),
+             "{\"type\":\"encoder\",\"device_id\":\"" DEVICE_ID "\",\"encoder_id\":12,\"value\":0.4173228,"
+             "\"direction\":-1,\"timestamp\":1234567}\r\n");
+    VectorSink encoder;
+    Writer writer(encoder);
+    writer.begin(BIN_MSG_ENCODER);
+    writer.put(12);
+    writer.put16((uint16_t)(0.4173228f * 65535));
+    writer.put((uint8_t)(int8_t)-1);
+    writer.put16((uint16_t)1234567);
+    writer.end();
+    report("encoder", strlen(line), encoder.bytes.size());
+
+    snprintf(line, sizeof(line), "{\"type\":\"stream_ack\",\"seq\":123456,\"credits\":2}\r\n");
+    VectorSink ack;
+    Writer ackWriter(ack);
+    ackWriter.begin(BIN_MSG_STREAM_ACK);
+    ackWriter.put32(123456);
+    ackWriter.put(2);
+    ackWriter.put(0);
+    ackWriter.put32(0);
+    ackWriter.end();
+    report("stream_ack", strlen(line), ack.bytes.size());
+
+    // Pi -> ESP32
+    const char* updateFormat =
+        "{\"type\":\"led_update\",\"encoder_id\":%d,\"color\":{\"r\":255,\"g\":128,\"b\":%d},"
+        "\"pattern\":\"ring_fill\",\"value\":0.5019608}\n";
+    snprintf(line, sizeof(line), updateFormat, 12, 64);
+    VectorSink update;
+    Writer updateWriter(update);
+    updateWriter.begin(BIN_MSG_LED_UPDATE);
+    const uint8_t packed[BIN_LED_UPDATE_BYTES] = {12, 255, 128, 64, PATTERN_RING_FILL, 0x80, 0x80};
+    updateWriter.put(packed, sizeof(packed));
+    updateWriter.end();
+    report("led_update", strlen(line), update.bytes.size());
+
+    std::string batch = "{\"type\":\"led_batch\",\"updates\":[";
+    VectorSink batchFrame;
+    Writer batchWriter(batchFrame);
+    batchWriter.begin(BIN_MSG_LED_BATCH);
+    batchWriter.put(NUM_ENCODERS);
+    for (int ring = 0; ring < NUM_ENCODERS; ring++) {
+        snprintf(line, sizeof(line),
+                 "%s{\"encoder_id\":%d,\"color\":{\"r\":255,\"g\":0,\"b\":%d},\"pattern\":\"solid\",\"value\":0.25}",
+                 ring ? "," : "", ring, ring * 16);
+        batch += line;
+        const uint8_t entry[BIN_LED_UPDATE_BYTES] = {(uint8_t)ring, 255, 0, (uint8_t)(ring * 16),
+                                                     PATTERN_SOLID, 0xFF, 0x3F};
+        batchWriter.put(entry, sizeof(entry));
+    }
+    batch += "]}\n";
+    batchWriter.end();
+    report("led_batch (every ring)", batch.size(), batchFrame.bytes.size());
+
+    std::string levels(4 * ((NUM_ENCODERS + 2) / 3), 'A');  // Base64 length is all that matters
+    snprintf(line, sizeof(line), "{\"type\":\"led_meter\",\"first\":0,\"levels\":\"%s\"}\n", levels.c_str());
+    VectorSink meter;
+    Writer meterWriter(meter);
+    meterWriter.begin(BIN_MSG_LED_METER);
+    meterWriter.put(0);
+    for (int ring = 0; ring < NUM_ENCODERS; ring++) meterWriter.put((uint8_t)(ring * 32));
+    meterWriter.end();
+    report("led_meter (every ring)", strlen(line), meter.bytes.size());
+}
+
+int main() {
+    bool ok = checkFormat();
+    ok = checkFramer() && ok;
+    compareSizes();
+    return ok ? 0 : 1;
+}
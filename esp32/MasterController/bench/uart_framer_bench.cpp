@@ -0,0 +1,174 @@
+// ============================================================================
+// UART Line Framer Benchmark (host)
+// Feeds a recorded-style mix of Pi -> ESP32 messages through LineFramer in
+// UART-sized chunks and reports framing throughput in bytes/s, compared
+// with the old per-character String append. Also checks that an oversized
+// line is dropped without losing the messages around it.
+//
+// Build & run from this directory:
+//   g++ -O2 -std=c++11 -I.. uart_framer_bench.cpp -o uart_framer_bench
+//   ./uart_framer_bench
+//
+// Only framing is measured - JSON parsing cost is the same for both paths.
+// ============================================================================
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <chrono>
+#include "config.h"
+#include "uart_framer.h"
+
+static const int BENCH_PASSES = 200;
+
+static std::string buildStream() {
+    std::string stream;
+    char line[256];
+    
+    for (int i = 0; i < 64; i++) {
+        snprintf(line, sizeof(line),
+                 "{\"type\":\"led_update\",\"encoder_id\":%d,\"color\":{\"r\":%d,\"g\":128,\"b\":0},"
+                 "\"pattern\":\"ring_fill\",\"value\":%.3f}%s\n",
+                 i % 16, (i * 37) & 0xFF, (i % 100) / 100.0, (i & 1) ? "\r" : "");
+        stream += line;
+        
+        stream += "{\"type\":\"led_meter\",\"first\":0,\"levels\":\"AEBggKDA4P8AQGCAoMDg/w==\"}\n";
+        
+        if (i % 8 == 0) {
+            stream += "{\"type\":\"led_batch\",\"updates\":[";
+            for (int ring = 0; ring < 16; ring++) {
+                snprintf(line, sizeof(line),
+                         "%s{\"encoder_id\":%d,\"color\":{\"r\":255,\"g\":0,\"b\":%d},\"pattern\":\"solid\"}",
+                         ring ? "," : "", ring, ring * 16);
+                stream += line;
+            }
+            stream += "]}\n";
+        }
+    }
+    return stream;
+}
+
+static uint32_t checksumLine(const char* line, size_t length) {
+    return (uint32_t)length * 31 + (uint8_t)line[0] + (uint8_t)line[length - 1];
+}
+
+// Old UARTComm::processIncomingData(): one char at a time into a String
+static uint32_t frameStringAppend(const std::string& stream, size_t chunk, unsigned long& lines) {
+    std::string inputBuffer;
+    inputBuffer.reserve(UART_BUFFER_SIZE);
+    uint32_t checksum = 0;
+    
+    for (size_t pos = 0; pos < stream.size(); pos += chunk) {
+        size_t end = std::min(pos + chunk, stream.size());
+        for (size_t i = pos; i < end; i++) {
+            char c = stream[i];
+            if (c == '\n') {
+                if (inputBuffer.length() > 0) {
+                    checksum += checksumLine(inputBuffer.c_str(), inputBuffer.length());
+                    lines++;
+                    inputBuffer = "";
+                }
+            } else if (c != '\r') {
+                inputBuffer += c;
+                if (inputBuffer.length() >= UART_BUFFER_SIZE - 1) {
+                    inputBuffer = "";
+                }
+            }
+        }
+    }
+    return checksum;
+}
+
+static uint32_t frameLineFramer(LineFramer<UART_BUFFER_SIZE>& framer, const std::string& stream, size_t chunk,
+                                unsigned long& lines) {
+    uint32_t checksum = 0;
+    size_t pos = 0;
+    
+    while (pos < stream.size()) {
+        size_t space;
+        char* dst = framer.writeBuffer(space);
+        size_t count = std::min(std::min(chunk, space), stream.size() - pos);
+        memcpy(dst, stream.data() + pos, count);  // Stands in for Serial.readBytes()
+        framer.commit(count);
+        pos += count;
+        
+        const char* line;
+        size_t length;
+        while (framer.nextLine(line, length)) {
+            checksum += checksumLine(line, length);
+            lines++;
+        }
+    }
+    return checksum;
+}
+
+static bool checkRecovery() {
+    // valid, oversized, valid - split at awkward points
+    std::string good1 = "{\"type\":\"led_update\",\"encoder_id\":1}";
+    std::string good2 = "{\"type\":\"led_update\",\"encoder_id\":2}";
+    std::string stream = good1 + "\n" + std::string(UART_BUFFER_SIZE * 2, 'x') + "\n" + good2 + "\r\n";
+    
+    bool ok = true;
+    const size_t chunks[] = {1, 7, 64, 4096};
+    for (size_t chunk : chunks) {
+        LineFramer<UART_BUFFER_SIZE> framer;
+        std::string seen;
+        size_t pos = 0;
+        while (pos < stream.size()) {
+            size_t space;
+            char* dst = framer.writeBuffer(space);
+            size_t count = std::min(std::min(chunk, space), stream.size() - pos);
+            memcpy(dst, stream.data() + pos, count);
+            framer.commit(count);
+            pos += count;
+            
+            const char* line;
+            size_t length;
+            while (framer.nextLine(line, length)) {
+                seen += std::string(line, length) + "|";
+            }
+        }
+        bool pass = (seen == good1 + "|" + good2 + "|") && framer.getOverflows() == 1;
+        printf("Recovery, %4zu-byte reads: %s (overflows=%lu)\n", chunk, pass ? "ok" : "FAILED",
+               framer.getOverflows());
+        ok = ok && pass;
+    }
+    return ok;
+}
+
+int main() {
+    bool ok = checkRecovery();
+    
+    std::string stream = buildStream();
+    printf("\nStream: %zu bytes per pass, %d passes, %d-byte framer\n", stream.size(), BENCH_PASSES, UART_BUFFER_SIZE);
+    
+    // 64 bytes = UART FIFO refill, 256 = a few ms at 921600 baud, 2048 = backlog
+    const size_t chunks[] = {64, 256, 2048};
+    for (size_t chunk : chunks) {
+        unsigned long linesOld = 0, linesNew = 0;
+        uint32_t checksumOld = 0, checksumNew = 0;
+        
+        auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < BENCH_PASSES; pass++) {
+            checksumOld += frameStringAppend(stream, chunk, linesOld);
+        }
+        double oldSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        LineFramer<UART_BUFFER_SIZE> framer;
+        start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < BENCH_PASSES; pass++) {
+            checksumNew += frameLineFramer(framer, stream, chunk, linesNew);
+        }
+        double newSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        double bytes = (double)stream.size() * BENCH_PASSES;
+        bool match = (linesOld == linesNew && checksumOld == checksumNew);
+        ok = ok && match;
+        printf("%4zu-byte reads: String append %8.1f MB/s -> LineFramer %8.1f MB/s (%5.1fx)  lines %s\n",
+               chunk, bytes / oldSeconds / 1e6, bytes / newSeconds / 1e6, oldSeconds / newSeconds,
+               match ? "match" : "DIFFER");
+    }
+    
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,254 @@
+// ============================================================================
+// UART Transmit Queue Benchmark (host)
+// Checks that TxQueue delivers messages whole and in order across ring wrap
+// with arbitrary drain budgets, and that coalescing (including squeezing out
+// replaced messages when the queue is short of room) keeps per-key order,
+// never loses a queued unkeyed message and leaves the latest value of every
+// key on the wire - also when the queue is already full of live messages
+// as the final value arrives. Then it replays a fast sweep of every encoder
+// against a UART with a small TX FIFO at 115200 baud and compares the old
+// blocking Serial.write() path with the coalescing queue: time the main loop
+// spends stalled, encoder messages on the wire, and whether the Pi ends up
+// with the final value of every encoder.
+//
+// Build & run from this directory:
+//   g++ -O2 -std=c++11 -I.. uart_tx_queue_bench.cpp -o uart_tx_queue_bench
+//   ./uart_tx_queue_bench
+//
+// Add -DLED_LAYOUT=LED_LAYOUT_16x28 for all 16 encoders.
+// ============================================================================
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "config.h"
+#include "uart_tx_queue.h"
+
+static const double UART_BYTES_PER_US = 115200.0 / 10 / 1e6;  // 8N1
+static const size_t UART_FIFO_BYTES = 256;                     // Driver TX buffer
+static const unsigned long LOOP_US = MAIN_LOOP_DELAY_MS * 1000;
+static const unsigned long SWEEP_US = 500000;                  // Encoders turning for 0.5 s
+static const unsigned long EVENT_US = 2000;                    // One detent per encoder every 2 ms
+
+typedef TxQueue<UART_TX_QUEUE_BYTES, UART_TX_QUEUE_ENTRIES> Queue;
+
+static const char PAD[] =
+    "................................................................................"
+    "................................................................................"
+    "................................................................................"
+    "................................................................................"
+    "................................................................................"
+    "................................................................................"
+    "................................................................................";
+
+struct VectorSink {
+    std::vector<uint8_t> bytes;
+    size_t limit = (size_t)-1;  // Accept at most this many bytes per call
+    size_t write(const uint8_t* data, size_t length) {
+        size_t count = length < limit ? length : limit;
+        bytes.insert(bytes.end(), data, data + count);
+        return count;
+    }
+};
+
+static bool checkOrder() {
+    Queue queue;
+    VectorSink sink;
+    std::string expected;
+    srand(7);
+
+    for (int i = 0; i < 20000; i++) {
+        char message[600];
+        int length = snprintf(message, sizeof(message), "{\"n\":%d,\"pad\":\"%.*s\"}\n", i, rand() % 500, PAD);
+        queue.begin(TX_KEY_NONE);
+        queue.write((const uint8_t*)message, length);
+        if (queue.commit()) expected.append(message, length);
+
+        sink.limit = 1 + rand() % 97;
+        queue.drain(sink, rand() % 400);
+    }
+    while (queue.getDepth() > 0) queue.drain(sink, 256);
+
+    bool ok = std::string(sink.bytes.begin(), sink.bytes.end()) == expected && queue.getBytes() == 0;
+    printf("Order across wrap, partial writes: %s (drops=%lu)\n", ok ? "ok" : "FAILED", queue.getDrops());
+    return ok;
+}
+
+static bool checkCoalescing() {
+    const int KEYS = 24;
+    Queue queue;
+    VectorSink sink;
+    int lastQueued[KEYS + 1] = {0};  // Key 0: unkeyed
+    unsigned long unkeyedQueued = 0;
+    srand(11);
+
+    for (int i = 1; i <= 50000; i++) {
+        int key = rand() % (KEYS + 1);
+        char message[600];
+        int length = snprintf(message, sizeof(message), "%d %d %.*s\n", key, i, rand() % 400, PAD);
+        queue.begin(key == 0 ? TX_KEY_NONE : 0x0100 + key);
+        queue.write((const uint8_t*)message, length);
+        if (queue.commit()) {
+            lastQueued[key] = i;
+            if (key == 0) unkeyedQueued++;
+        }
+
+        sink.limit = 1 + rand() % 97;
+        queue.drain(sink, rand() % 300);
+    }
+    while (queue.getDepth() > 0) queue.drain(sink, 256);
+
+    // Every line whole, sequence rising per key, latest value per key last
+    int lastSent[KEYS + 1] = {0};
+    unsigned long unkeyedSent = 0;
+    bool ok = queue.getBytes() == 0;
+    std::string text(sink.bytes.begin(), sink.bytes.end());
+    for (size_t pos = 0, end; ok && (end = text.find('\n', pos)) != std::string::npos; pos = end + 1) {
+        int key, seq, padStart = 0;
+        ok = sscanf(text.c_str() + pos, "%d %d%n", &key, &seq, &padStart) == 2 && key >= 0 && key <= KEYS &&
+             text[pos + padStart] == ' ' && text.find_first_not_of('.', pos + padStart + 1) == end &&
+             seq > lastSent[key];
+        if (!ok) break;
+        lastSent[key] = seq;
+        if (key == 0) unkeyedSent++;
+    }
+    for (int key = 0; key <= KEYS; key++) ok = ok && lastSent[key] == lastQueued[key];
+    ok = ok && unkeyedSent == unkeyedQueued;
+
+    printf("Coalescing under pressure: %s (%lu coalesced, %lu drops, %lu of %lu unkeyed delivered)\n",
+           ok ? "ok" : "FAILED", queue.getCoalesced(), queue.getDrops(), unkeyedSent, unkeyedQueued);
+    return ok;
+}
+
+// Fill the queue with unkeyed messages after one value for key 1, then send
+// the final value for key 1 into the full queue. Out of entries, it must
+// replace the stale one; out of bytes it cannot be stored, and the stale one
+// must survive rather than both being lost.
+template <size_t Capacity, size_t MaxEntries>
+static bool checkFullQueue(const char* name, bool replaces) {
+    TxQueue<Capacity, MaxEntries> queue;
+    VectorSink sink;
+    const char* stale = "encoder 1 stale\n";
+    const char* final = "encoder 1 final\n";
+
+    queue.begin(0x0101);
+    queue.write((const uint8_t*)stale, strlen(stale));
+    bool ok = queue.commit();
+    for (int i = 0;; i++) {
+        char message[128];
+        int length = snprintf(message, sizeof(message), "filler %d %.*s\n", i, 60, PAD);
+        queue.begin(TX_KEY_NONE);
+        queue.write((const uint8_t*)message, length);
+        if (!queue.commit()) break;
+    }
+
+    queue.begin(0x0101);
+    queue.write((const uint8_t*)final, strlen(final));
+    ok = queue.commit() == replaces && ok;
+    while (queue.getDepth() > 0) queue.drain(sink, 256);
+
+    std::string text(sink.bytes.begin(), sink.bytes.end());
+    bool staleSent = text.find(stale) != std::string::npos;
+    bool finalSent = text.find(final) != std::string::npos;
+    ok = ok && staleSent != replaces && finalSent == replaces;
+    printf("Final value into a queue full of %s: %s\n", name, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+static int encoderMessage(char* out, size_t size, int encoder, int step) {
+    // Same shape as UARTComm::sendEncoderUpdate() in JSON framing
+    return snprintf(out, size,
+                    "{\"type\":\"encoder\",\"device_id\":\"" DEVICE_ID "\",\"encoder_id\":%d,\"value\":%.7f,"
+                    "\"direction\":1,\"timestamp\":%d}\r\n", encoder, step / 1000.0, 1000000 + step);
+}
+
+// Old path: every message written synchronously; the loop stalls whenever
+// the driver FIFO has no room left
+static void runBlocking() {
+    double fifo = 0;
+    double stalledUs = 0;
+    unsigned long messages = 0;
+    char message[256];
+
+    for (unsigned long t = 0; t < SWEEP_US; t += LOOP_US) {
+        fifo = fifo > LOOP_US * UART_BYTES_PER_US ? fifo - LOOP_US * UART_BYTES_PER_US : 0;
+        if (t % EVENT_US != 0) continue;
+
+        for (int encoder = 0; encoder < NUM_ENCODERS; encoder++) {
+            int length = encoderMessage(message, sizeof(message), encoder, (int)(t / EVENT_US));
+            fifo += length;
+            if (fifo > UART_FIFO_BYTES) {
+                double waitUs = (fifo - UART_FIFO_BYTES) / UART_BYTES_PER_US;
+                stalledUs += waitUs;
+                fifo = UART_FIFO_BYTES;
+            }
+            messages++;
+        }
+    }
+    printf("Blocking writes: %6lu encoder messages sent, loop stalled %7.1f ms of %lu ms\n",
+           messages, stalledUs / 1000, SWEEP_US / 1000);
+}
+
+static bool runQueued() {
+    Queue queue;
+    VectorSink wire;
+    double fifo = 0;
+    char message[256];
+    int lastStep = 0;
+
+    unsigned long t = 0;
+    for (; t < SWEEP_US || queue.getDepth() > 0; t += LOOP_US) {
+        fifo = fifo > LOOP_US * UART_BYTES_PER_US ? fifo - LOOP_US * UART_BYTES_PER_US : 0;
+
+        if (t < SWEEP_US && t % EVENT_US == 0) {
+            lastStep = (int)(t / EVENT_US);
+            for (int encoder = 0; encoder < NUM_ENCODERS; encoder++) {
+                int length = encoderMessage(message, sizeof(message), encoder, lastStep);
+                queue.begin(0x0100 + encoder);
+                queue.write((const uint8_t*)message, length);
+                queue.commit();
+            }
+        }
+
+        // uart.update(): only what fits in the driver FIFO right now
+        size_t sent = queue.drain(wire, UART_FIFO_BYTES - (size_t)fifo);
+        fifo += sent;
+    }
+
+    // The last message the Pi saw for each encoder must carry the final value
+    std::string text(wire.bytes.begin(), wire.bytes.end());
+    bool ok = true;
+    for (int encoder = 0; encoder < NUM_ENCODERS; encoder++) {
+        char expected[256];
+        encoderMessage(expected, sizeof(expected), encoder, lastStep);
+        char id[32];
+        snprintf(id, sizeof(id), "\"encoder_id\":%d,", encoder);
+        size_t last = text.rfind(id);
+        size_t lineStart = text.rfind("{", last);
+        ok = ok && last != std::string::npos && text.compare(lineStart, strlen(expected), expected) == 0;
+    }
+
+    unsigned long messages = 0;
+    for (size_t pos = 0; (pos = text.find("\r\n", pos)) != std::string::npos; pos += 2) messages++;
+    printf("Queued writes:   %6lu encoder messages sent, loop stalled %7.1f ms, %lu coalesced, %lu dropped,\n"
+           "                 max depth %zu, wire idle after %lu ms, final values %s\n",
+           messages, 0.0, queue.getCoalesced(), queue.getDrops(), queue.getMaxDepth(), t / 1000,
+           ok ? "delivered" : "WRONG");
+    return ok;
+}
+
+int main() {
+    bool ok = checkOrder();
+    ok = checkCoalescing() && ok;
+    ok = checkFullQueue<UART_TX_QUEUE_BYTES, UART_TX_QUEUE_ENTRIES>("entries", true) && ok;
+    ok = checkFullQueue<UART_TX_QUEUE_BYTES, 1024>("bytes", false) && ok;
+
+    printf("\n%d encoders, one event each every %lu us for %lu ms; %zu-byte TX FIFO at 115200 baud\n",
+           NUM_ENCODERS, EVENT_US, SWEEP_US / 1000, UART_FIFO_BYTES);
+    runBlocking();
+    ok = runQueued() && ok;
+    return ok ? 0 : 1;
+}
@@ -13,31 +13,119 @@
 #define LED_DATA_PIN D0        // D0 on XIAO ESP32-S3  
 #define LED_CLOCK_PIN D1       // D1 on XIAO ESP32-S3
 
+// Additional LED strips for large ring counts (see LED_STRIP_COUNT)
+#define LED_STRIP1_DATA_PIN D2
+#define LED_STRIP1_CLOCK_PIN D3
+#define LED_STRIP2_DATA_PIN D9
+#define LED_STRIP2_CLOCK_PIN D10
+
 // I2C Encoders - SDA/SCL  
 #define I2C_SDA_PIN 6      // SDA on XIAO ESP32-S3
 #define I2C_SCL_PIN 7      // SCL on XIAO ESP32-S3
 
-// UART Communication (Pi) - TX/RX (built-in USB-Serial)
+// UART Communication (Pi) - TX/RX (built-in USB-Serial), protocol only
 #define UART_BAUD 115200
 
 // Hardware Configuration
 // ============================================================================
 
+// Hardware Layout
+// Per-ring geometry (LED count, start, rotation, direction) lives in ring_layout.h
+#define LED_LAYOUT_BENCH 0     // Single 72-LED test strip (144 LEDs/meter × 0.5 meters)
+#define LED_LAYOUT_16x28 1     // Full panel: 16 rings × 28 LEDs = 448 LEDs
+#ifndef LED_LAYOUT
+#define LED_LAYOUT LED_LAYOUT_BENCH
+#endif
+
 // Encoder Setup
+#if LED_LAYOUT == LED_LAYOUT_16x28
+#define NUM_ENCODERS 16
+#else
 #define NUM_ENCODERS 1
-#define I2C_ENCODER_BASE_ADDR 0x20  // Addresses 0x20-0x27
+#endif
+#define I2C_ENCODER_BASE_ADDR 0x20  // Addresses 0x20 - 0x20 + NUM_ENCODERS - 1 (0x2F with 16 encoders)
 
 // LED Configuration  
-#define LEDS_PER_ENCODER 72    // 144 LEDs/meter × 0.5 meters = 72 LEDs
-#define TOTAL_LEDS (NUM_ENCODERS * LEDS_PER_ENCODER)  // 72 LEDs total
+#if LED_LAYOUT == LED_LAYOUT_16x28
+#define TOTAL_LEDS 448         // 16 rings × 28 LEDs
+#define LED_STRIP_COUNT 2      // 8 rings per strip, strip slices in ring_layout.h
+#else
+#define TOTAL_LEDS 72          // 72 LEDs total
+#define LED_STRIP_COUNT 1
+#endif
+#define LED_MAX_STRIPS 3       // Strip 0 on LED_DATA/CLOCK_PIN, strips 1-2 above
 #define LED_BRIGHTNESS 12      // LOWER brightness for better 3.3V compatibility
 #define LED_TYPE APA102        // DotStar uses APA102
 #define COLOR_ORDER RGB        // Test RGB first
+#define LED_MAX_VOLTS 5        // Power limit applied on output
+#define LED_MAX_MILLIAMPS 1000
+#define LED_COLOR_CORRECTION TypicalLEDStrip
+#define LED_COLOR_TEMPERATURE Tungsten40W  // Warmer color temperature
 
 // Debugging Options
 #define ENABLE_LED_DIAGNOSTICS true
 #define SAFE_MODE true         // Slower timing, more conservative power
-#define LED_UPDATE_RATE_MS 50  // SLOWER updates for 3.3V compatibility (20 FPS)
+
+// LED Frame Scheduling
+// The frame rate follows the content: changed rings go out at the
+// interactive rate, animations at their own rate, static content at 0 FPS.
+#define LED_FRAME_US_INTERACTIVE 8000  // 125 FPS for value/color changes (encoder feedback)
+#define LED_FRAME_US_PULSE 33333       // 30 FPS for pulse/error breathing
+#define LED_FRAME_US_RAINBOW 33333     // 30 FPS for rainbow rotation
+#define LED_FRAME_US_PROGRAM 16667     // 60 FPS for keyframe program fades
+#define LED_FRAME_US_METER 16667       // 60 FPS for level meter ballistics
+#define LED_FRAME_US_IDLE 33333        // Idle check rate - nothing is sent while static
+#define LED_ANIMATION_PERIOD_US 2500000 // One pulse/rainbow cycle (2.5 s)
+#define LED_MIN_SHOW_INTERVAL_US 4000  // Rate limit on all strip pushes (frame ticks and encoder fast path)
+#define LED_STATS_LATE_US 2000         // A frame tick this far past its deadline counts as missed (led_stats.h)
+#define LED_VALUE_TWEEN_US 50000       // Ring fill eases toward new values with this time constant (0 = jump)
+#define LED_FRAME_US_CROSSFADE 16667   // 60 FPS while a ring crossfades
+
+// Ring Layers
+// Each ring is composited as base pattern -> crossfade from the previous
+// look -> overlays (value markers, modulation ranges) set by led_overlay
+#define LED_CROSSFADE_US 150000        // led_update pattern/color changes fade over this time (0 = hard cut)
+#define LED_OVERLAY_MAX 2              // Overlay slots per ring, drawn in slot order
+
+// Integrity Refresh
+// Resends the retained frame to strips that have not been written recently,
+// so a strip that latched corrupted data recovers without a visible flash
+#define LED_REFRESH_OFF 0
+#define LED_REFRESH_RESEND 1
+#define LED_REFRESH_MODE LED_REFRESH_RESEND
+#define LED_REFRESH_INTERVAL_MS 5000
+
+// Level Meters (PATTERN_METER)
+// Instant attack, then the bar falls at a fixed rate; the peak LED holds
+// before falling. Zones are fractions of the ring (0-255).
+#define LED_METER_DECAY_US 600000      // Full-scale fall time of the bar
+#define LED_METER_PEAK_HOLD_US 1000000 // Peak LED hold before it starts falling
+#define LED_METER_PEAK_DECAY_US 1500000 // Full-scale fall time of the peak LED
+#define LED_METER_WARN_LEVEL 179       // ~70% - amber from here
+#define LED_METER_CLIP_LEVEL 230       // ~90% - red from here
+#define LED_METER_WARN_COLOR CRGB(255, 140, 0)
+#define LED_METER_CLIP_COLOR CRGB(255, 0, 0)
+
+// Pixel Streaming (led_stream.h)
+#define LED_STREAM_WINDOW 2            // Stream frames the Pi may send ahead of the last stream_ack
+#define LED_STREAM_MAX_BYTES (TOTAL_LEDS * 3 + TOTAL_LEDS / 64 + 8) // Decoded ops for one literal frame
+
+// LED Output Task
+// Strip transfers run in a FreeRTOS task on the other core so UART and I2C
+// servicing in loop() never wait behind them. Off by default until it has
+// run on the panel: the strip drivers have only ever been driven from
+// loop() on core 1. With it off, each push blocks loop() for its transfer.
+#define LED_OUTPUT_TASK false
+#define LED_OUTPUT_TASK_CORE 0         // loop() runs on core 1
+#define LED_OUTPUT_TASK_PRIORITY 2
+#define LED_OUTPUT_TASK_STACK 4096
+
+// APA102 HDR Output (led_output_apa102.h)
+// Drive the strips over SPI using the per-pixel 5-bit brightness field, so
+// low LED_BRIGHTNESS keeps full color depth. Opt-in until validated on the
+// strips - false = FastLED output.
+#define LED_OUTPUT_HDR false
+#define LED_HDR_SPI_HZ 8000000         // Reliable through the 74HCT245 level shifter
 
 // I2C Configuration
 #define I2C_FREQUENCY 400000  // 400kHz standard speed
@@ -54,16 +142,44 @@
 // Communication Protocol
 // ============================================================================
 
-#define UART_BUFFER_SIZE 1024
-#define JSON_BUFFER_SIZE 1024
+#define UART_BUFFER_SIZE 2048         // Fits a led_batch covering every ring
+#define JSON_BUFFER_SIZE 4096         // Receive document, allocated once
+#define JSON_TX_DOC_SIZE 2048         // Outgoing document, allocated once - status is the largest
+#define JSON_TX_BUFFER_SIZE 2048      // Serialized outgoing line incl. CRLF
+#define UART_TX_QUEUE_BYTES 8192      // Outgoing messages waiting for the UART (uart_tx_queue.h)
+#define UART_TX_QUEUE_ENTRIES 64
+#define UART_TX_LOG_LIMIT (UART_TX_QUEUE_BYTES / 2) // Log lines are refused past this fill
 #define MAX_MESSAGE_LENGTH 512
+#define ERROR_MESSAGE_MAX 128       // "error" text, formatted on the stack
 
 // System Configuration
 // ============================================================================
 
 #define FIRMWARE_VERSION "1.0.0"
 #define DEVICE_ID "esp32_master"
-#define DEBUG_SERIAL true
+
+// Logging (logger.h)
+// Log lines never go onto the Pi link as raw text. They are sent as "log"
+// messages the Pi can filter by type, or to a second UART, or nowhere.
+#define LOG_OUTPUT_NONE 0
+#define LOG_OUTPUT_PROTOCOL 1  // {"type":"log",...} / binary log frames on the Pi link
+#define LOG_OUTPUT_UART 2      // Plain text on LOG_UART_TX_PIN
+#ifndef LOG_OUTPUT
+#define LOG_OUTPUT LOG_OUTPUT_PROTOCOL
+#endif
+#define LOG_UART_TX_PIN D6     // Hardware UART TX - free while the Pi link is on USB
+#define LOG_UART_BAUD 115200
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+#ifndef LOG_LEVEL_COMPILED
+#define LOG_LEVEL_COMPILED LOG_LEVEL_DEBUG  // Calls above this level compile to nothing
+#endif
+#define LOG_LEVEL_DEFAULT LOG_LEVEL_INFO    // Runtime level at boot ("log_level" command)
+#define LOG_LINE_MAX 160                    // Formatted message, longer ones are truncated
 
 // LED Patterns
 // ============================================================================
@@ -73,7 +189,34 @@ enum LEDPattern {
   PATTERN_RING_FILL,
   PATTERN_PULSE,
   PATTERN_RAINBOW,
-  PATTERN_ERROR
+  PATTERN_ERROR,
+  PATTERN_PROGRAM,      // Keyframe program played on-device (led_program.h)
+  PATTERN_STREAM,       // Pixels streamed from the Pi (led_stream.h)
+  PATTERN_METER         // Level meter fed by led_meter frames
+};
+
+#define LED_PROGRAM_MAX_KEYFRAMES 8
+
+// One ring update as carried by led_update / led_batch
+struct LEDRingUpdate {
+  int encoderId;
+  uint8_t r, g, b;
+  LEDPattern pattern;
+  float value;
+};
+
+enum OverlayKind {
+  OVERLAY_NONE,
+  OVERLAY_MARKER,       // Single LED at start
+  OVERLAY_RANGE         // Arc from start to end
+};
+
+// One overlay as carried by led_overlay; positions are 0-65535 around the ring
+struct LEDOverlay {
+  uint8_t kind;         // OverlayKind
+  uint8_t r, g, b;
+  uint8_t alpha;        // 255 = replaces the base pattern
+  uint16_t start, end;
 };
 
 // Message Types
@@ -83,7 +226,18 @@ enum LEDPattern {
 #define MSG_TYPE_STATUS "status"
 #define MSG_TYPE_ENCODER "encoder"
 #define MSG_TYPE_LED_UPDATE "led_update"
+#define MSG_TYPE_LED_BATCH "led_batch"
+#define MSG_TYPE_LED_PROGRAM "led_program"
+#define MSG_TYPE_LED_PROGRAM_CMD "led_program_cmd"
+#define MSG_TYPE_LED_STREAM "led_stream"
+#define MSG_TYPE_STREAM_ACK "stream_ack"
+#define MSG_TYPE_LED_METER "led_meter"
+#define MSG_TYPE_LED_OVERLAY "led_overlay"
+#define MSG_TYPE_LED_STATS "led_stats"
 #define MSG_TYPE_ERROR "error"
 #define MSG_TYPE_I2C_SCAN "i2c_scan"
+#define MSG_TYPE_DIAGNOSTIC "diagnostic"
+#define MSG_TYPE_PROTOCOL "protocol"
+#define MSG_TYPE_LOG "log"
 
 #endif // CONFIG_H 
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "i2c_encoder.h"
 #include "uart_comm.h"
+#include "logger.h"
 
 // Global instance
 I2CEncoderManager i2cEncoders;
@@ -23,7 +24,7 @@ void I2CEncoderManager::begin() {
     connectedCount = 0;
     initialized = true;
     
-    Serial.println("[I2C] I2C Encoder Manager initialized");
+    LOG_INFO("I2C", "I2C Encoder Manager initialized");
     
     // Initial scan for connected devices
     scanForEncoders();
@@ -49,7 +50,7 @@ void I2CEncoderManager::update() {
 }
 
 void I2CEncoderManager::scanForEncoders() {
-    Serial.println("[I2C] Scanning for encoder devices...");
+    LOG_DEBUG("I2C", "Scanning for encoder devices...");
     
     connectedCount = 0;
     
@@ -63,17 +64,17 @@ void I2CEncoderManager::scanForEncoders() {
         if (isConnected) {
             connectedCount++;
             if (!wasConnected) {
-                Serial.printf("[I2C] Encoder %d found at address 0x%02X\n", i, address);
+                LOG_INFO("I2C", "Encoder %d found at address 0x%02X", i, address);
             }
         } else if (wasConnected) {
-            Serial.printf("[I2C] Encoder %d disconnected from address 0x%02X\n", i, address);
+            LOG_INFO("I2C", "Encoder %d disconnected from address 0x%02X", i, address);
         }
         
         // Send scan result via UART
         uart.sendI2CScanResult(address, isConnected);
     }
     
-    Serial.printf("[I2C] Scan complete - %d encoders connected\n", connectedCount);
+    LOG_DEBUG("I2C", "Scan complete - %d encoders connected", connectedCount);
 }
 
 bool I2CEncoderManager::isI2CDevicePresent(uint8_t address) {
@@ -134,8 +135,8 @@ void I2CEncoderManager::detectEncoderChanges(int encoderId, int32_t newPosition)
         // Call callback function
         onEncoderChanged(encoderId, encoder.normalizedValue, encoder.lastDirection);
         
-        Serial.printf("[I2C] Encoder %d changed: pos=%d, value=%.3f, dir=%d\n", 
-                      encoderId, newPosition, encoder.normalizedValue, encoder.lastDirection);
+        LOG_DEBUG("I2C", "Encoder %d changed: pos=%d, value=%.3f, dir=%d",
+                  encoderId, newPosition, encoder.normalizedValue, encoder.lastDirection);
     }
 }
 
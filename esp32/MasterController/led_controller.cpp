@@ -1,16 +1,18 @@
 #include "led_controller.h"
+#include "logger.h"
 
 // Global instance
 LEDController ledController;
 
-void LEDController::begin() {
-    // Initialize FastLED for DotStar/APA102 with slower timing
-    FastLED.addLeds<LED_TYPE, LED_DATA_PIN, LED_CLOCK_PIN, COLOR_ORDER>(leds, TOTAL_LEDS).setCorrection(TypicalLEDStrip);
-    
-    // More conservative settings for troubleshooting
-    FastLED.setBrightness(LED_BRIGHTNESS);
-    FastLED.setMaxPowerInVoltsAndMilliamps(5, 1000);  // Increased current limit
-    FastLED.setTemperature(Tungsten40W); // Warmer color temperature
+void LEDController::begin(LEDOutput& ledOutput) {
+    output = &ledOutput;
+    output->begin(leds, TOTAL_LEDS);
+    brightness = LED_BRIGHTNESS;
+    output->setBrightness(brightness);
+    framePower = 0;
+    for (int i = 0; i < NUM_ENCODERS; i++) {
+        ringPower[i] = 0;
+    }
     
     // Longer stabilization time for better compatibility
     #ifdef SAFE_MODE
@@ -19,30 +21,76 @@ void LEDController::begin() {
     
     // Multiple clear cycles to ensure clean start
     for(int i = 0; i < 3; i++) {
-        FastLED.clear();
-        FastLED.show();
+        clearBuffer();
+        showFullFrame();
         delay(100);
     }
     
-    Serial.println("[LED] LED strip cleared and stabilized");
+    LOG_INFO("LED", "LED strip cleared and stabilized");
     
     // Initialize encoder rings
+    buildRingLayout();
     for (int i = 0; i < NUM_ENCODERS; i++) {
-        encoderRings[i].startIndex = i * LEDS_PER_ENCODER;
         encoderRings[i].color = CRGB::Black;
         encoderRings[i].pattern = PATTERN_OFF;
         encoderRings[i].value = 0.0;
+        encoderRings[i].shownValue = 0;
         encoderRings[i].active = false;
         encoderRings[i].lastUpdate = 0;
-        encoderRings[i].animationPhase = 0.0;
+        encoderRings[i].animationPhase = 0;
+        encoderRings[i].dirty = true;
+        encoderRings[i].commitPending = false;
+        ringPrograms[i].program.count = 0;
+        ringPrograms[i].loaded = false;
+        meters[i].target = 0;
+        meters[i].level = 0;
+        meters[i].peak = 0;
+        meters[i].peakMicros = 0;
+        ringLayers[i].fading = false;
+        ringLayers[i].fadeStartMicros = 0;
+        clearOverlays(i);
+        updateStaged[i] = false;
     }
+    anyUpdateStaged = false;
+    updatesCoalesced = 0;
     
-    lastFrameUpdate = 0;
+    for (int i = 0; i < TOTAL_LEDS; i++) {
+        streamFrame[i] = CRGB::Black;
+        fadeFrom[i] = CRGB::Black;
+    }
+    streamSeq = 0;
+    streamPending = 0;
+    streamAckDue = false;
+    streamResync = false;
+    streamFrames = 0;
+    streamDropped = 0;
+    streamSuperseded = 0;
+    
+    diag.task = DIAG_NONE;
+    lastFrameMicros = micros();
+    frameMicros = lastFrameMicros;
+    lastAnimationMicros = lastFrameMicros;
+    animationRemainder = 0;
+    lastShowMicros = lastFrameMicros;
+    pendingStripMask = 0;
+    framePushPending = false;
+    fullFramePending = false;
+    markStripsPushed(LED_ALL_STRIPS);
+    refreshCount = 0;
+    refreshTotalUs = 0;
+    latencyPending = false;
+    latencyEventMicros = 0;
+    latencyLastUs = 0;
+    latencyMaxUs = 0;
+    latencyTotalUs = 0;
+    latencySamples = 0;
+    framesRendered = 0;
+    framesSkipped = 0;
+    frameStatsReset(frameStats);
+    lastUpdateMicros = lastFrameMicros;
     initialized = true;
     
-    Serial.printf("[LED] FastLED initialized - DotStar/APA102 strips ready\n");
-    Serial.printf("[LED] Type: %s, Pins: DATA=%d CLOCK=%d, LEDs: %d\n", 
-                  "APA102", LED_DATA_PIN, LED_CLOCK_PIN, TOTAL_LEDS);
+    LOG_INFO("LED", "Output backend: %s, LEDs: %d", output->getName(), TOTAL_LEDS);
     
     // Show startup sequence
     showStartupSequence();
@@ -51,52 +99,127 @@ void LEDController::begin() {
 void LEDController::update() {
     if (!initialized) return;
     
-    unsigned long currentTime = millis();
+    unsigned long currentMicros = micros();
+    unsigned long previousUpdateMicros = lastUpdateMicros;
+    lastUpdateMicros = currentMicros;
     
-    // Use the configurable update rate for 3.3V compatibility
-    if (currentTime - lastFrameUpdate < LED_UPDATE_RATE_MS) {
-        return;
+    // A frame rendered while the output was still transferring goes out
+    // as soon as the output frees up
+    if (framePushPending && !output->isBusy()) {
+        pushFrame();
     }
     
-    // Update animation phases
-    updateAnimationPhases();
-    
-    // Render all encoder rings
-    for (int i = 0; i < NUM_ENCODERS; i++) {
-        renderEncoder(i);
+    // A running diagnostic owns the strip until it finishes or is cancelled
+    if (diag.task != DIAG_NONE) {
+        applyStagedUpdates();
+        updateDiagnostic();
+        return;
     }
     
-    // Add small delay before show() for signal stability
-    delayMicroseconds(10);
+    unsigned long currentTime = millis();
     
-    // Update LED strip with error recovery
-    static int errorCount = 0;
-    FastLED.show();
+    // Encoder changes held back by the show() rate limit go out first -
+    // unless they are already rendered and waiting on the output above
+    if (latencyPending && !framePushPending && currentMicros - lastShowMicros >= LED_MIN_SHOW_INTERVAL_US) {
+        commitPendingRings();
+    }
     
-    // Periodic refresh to combat data corruption
-    static unsigned long lastRefresh = 0;
-    if (currentTime - lastRefresh > 5000) { // Every 5 seconds
-        // Clear and re-render to fix any corruption
-        FastLED.clear();
-        FastLED.show();
-        delay(10);
+    // Frame rate is chosen from the current ring content. A tick that falls
+    // due right after a fast-path commit waits out the same show() rate
+    // limit, so the two together never push faster than it allows.
+    unsigned long frameInterval = getFrameIntervalUs();
+    unsigned long showAllowedMicros = lastShowMicros + LED_MIN_SHOW_INTERVAL_US;
+    if (currentMicros - lastFrameMicros >= frameInterval && (long)(currentMicros - showAllowedMicros) >= 0) {
+        // The tick fell due at its scheduled time, or at the previous
+        // update() if content changed since, or when the rate limit let it
+        // through - anything well past that means the main loop was held up
+        unsigned long dueMicros = lastFrameMicros + frameInterval;
+        if ((long)(previousUpdateMicros - dueMicros) > 0) dueMicros = previousUpdateMicros;
+        if ((long)(showAllowedMicros - dueMicros) > 0) dueMicros = showAllowedMicros;
+        unsigned long lateUs = currentMicros - dueMicros;
+        if (lateUs > LED_STATS_LATE_US) {
+            frameStats.missed++;
+            histogramRecord(frameStats.late, lateUs);
+        }
+        
+        lastFrameMicros = currentMicros;
+        frameMicros = currentMicros;
+        unsigned long renderStart = micros();
+        
+        // Collapse everything the Pi sent since the last frame
+        applyStagedUpdates();
         
+        // Advance animations by real elapsed time
+        updateAnimationPhases(currentMicros);
+        
+        // Render only the rings whose output changed since the last frame
+        bool anyDirty = false;
         for (int i = 0; i < NUM_ENCODERS; i++) {
-            renderEncoder(i);
+            if (encoderRings[i].dirty) {
+                renderEncoder(i);
+                encoderRings[i].dirty = false;
+                encoderRings[i].commitPending = false;
+                anyDirty = true;
+            }
         }
-        FastLED.show();
         
-        lastRefresh = currentTime;
-        Serial.println("[LED] Periodic refresh completed");
+        if (anyDirty) {
+            histogramRecord(frameStats.render, micros() - renderStart);
+            pushFrame();
+        } else {
+            // Nothing changed - skip the strip transfer entirely
+            framesSkipped++;
+        }
     }
     
-    lastFrameUpdate = currentTime;
+#if LED_REFRESH_MODE == LED_REFRESH_RESEND
+    // Periodic refresh to combat data corruption
+    refreshStaleStrips(currentTime);
+#endif
+}
+
+void LEDController::refreshStaleStrips(unsigned long currentTime) {
+    // The frame buffer always holds the complete current frame, so a refresh
+    // is a plain resend - only strips that have been quiet for a full
+    // interval need it
+    uint32_t staleMask = 0;
+    for (int i = 0; i < LED_STRIP_COUNT; i++) {
+        if (currentTime - stripPushMillis[i] >= LED_REFRESH_INTERVAL_MS) {
+            staleMask |= 1UL << i;
+        }
+    }
+    if (staleMask == 0 || output->isBusy()) return;
+    
+    // Refused by a busy output - the strips stay stale and are retried
+    if (!output->show(staleMask)) return;
+    
+    // Strip transfer time as measured by the backend - with the output task
+    // show() only hands the frame off, so timing it here would understate
+    // the cost. Tasked, this is each strip's previous transfer, which only
+    // depends on its LED count.
+    for (int i = 0; i < LED_STRIP_COUNT; i++) {
+        if (staleMask & (1UL << i)) {
+            refreshTotalUs += output->getStripShowMicros(i);
+        }
+    }
+    refreshCount++;
+    markStripsPushed(staleMask);
+}
+
+void LEDController::markStripsPushed(uint32_t stripMask) {
+    unsigned long now = millis();
+    for (int i = 0; i < LED_STRIP_COUNT; i++) {
+        if (stripMask & (1UL << i)) {
+            stripPushMillis[i] = now;
+        }
+    }
 }
 
 void LEDController::renderEncoder(int encoderId) {
     if (!isValidEncoderId(encoderId)) return;
     
     EncoderRing& ring = encoderRings[encoderId];
+    pendingStripMask |= 1UL << ring.strip;
     
     switch (ring.pattern) {
         case PATTERN_OFF:
@@ -117,119 +240,553 @@ void LEDController::renderEncoder(int encoderId) {
         case PATTERN_ERROR:
             renderPulse(encoderId); // Use pulse for error indication
             break;
+        case PATTERN_PROGRAM:
+            renderProgram(encoderId);
+            break;
+        case PATTERN_STREAM:
+            renderStream(encoderId);
+            break;
+        case PATTERN_METER:
+            renderMeter(encoderId);
+            break;
         default:
             renderOff(encoderId);
             break;
     }
+    
+    composeLayers(encoderId);
+    updateRingPower(encoderId);
+}
+
+void LEDController::composeLayers(int encoderId) {
+    // The base pattern is already in leds; the crossfade and overlays are
+    // blended over it in place, so rings without layers cost nothing extra
+    EncoderRing& ring = encoderRings[encoderId];
+    RingLayers& layers = ringLayers[encoderId];
+    const uint16_t* indexMap = &ledMap[ring.mapIndex];
+    
+    if (layers.fading) {
+        unsigned long elapsed = frameMicros - layers.fadeStartMicros;
+        if ((long)elapsed < 0) elapsed = 0;
+        
+        if (elapsed >= LED_CROSSFADE_US) {
+            layers.fading = false;
+        } else {
+            uint16_t weight = (uint16_t)((elapsed << 8) / LED_CROSSFADE_US);
+            patternCrossfade(leds, indexMap, ring.ledCount, fadeFrom, weight);
+        }
+    }
+    
+    for (int i = 0; i < LED_OVERLAY_MAX; i++) {
+        const LEDOverlay& overlay = layers.overlays[i];
+        if (overlay.kind == OVERLAY_NONE) continue;
+        
+        int first = ((uint32_t)overlay.start * ring.ledCount) >> 16;
+        int last = first;
+        if (overlay.kind == OVERLAY_RANGE) {
+            last = ((uint32_t)overlay.end * ring.ledCount) >> 16;
+            if (last < first) {
+                int swap = first;
+                first = last;
+                last = swap;
+            }
+        }
+        
+        patternOverlaySpan(leds, indexMap, ring.ledCount, first, last,
+                           CRGB(overlay.r, overlay.g, overlay.b), patternAlphaWeight(overlay.alpha));
+    }
+}
+
+void LEDController::startCrossfade(int encoderId) {
+    if (LED_CROSSFADE_US == 0 || diag.task != DIAG_NONE) return;
+    
+    // Fade from what the ring shows now - mid-fade that is the blend
+    // itself, so back-to-back changes stay continuous
+    EncoderRing& ring = encoderRings[encoderId];
+    const uint16_t* indexMap = &ledMap[ring.mapIndex];
+    for (int i = 0; i < ring.ledCount; i++) {
+        fadeFrom[indexMap[i]] = leds[indexMap[i]];
+    }
+    
+    ringLayers[encoderId].fadeStartMicros = micros();
+    ringLayers[encoderId].fading = true;
+}
+
+bool LEDController::setOverlay(int encoderId, int slot, const LEDOverlay& overlay) {
+    if (!isValidEncoderId(encoderId) || slot < 0 || slot >= LED_OVERLAY_MAX) return false;
+    
+    ringLayers[encoderId].overlays[slot] = overlay;
+    encoderRings[encoderId].dirty = true;
+    return true;
+}
+
+void LEDController::clearOverlays(int encoderId) {
+    if (!isValidEncoderId(encoderId)) return;
+    
+    for (int i = 0; i < LED_OVERLAY_MAX; i++) {
+        ringLayers[encoderId].overlays[i].kind = OVERLAY_NONE;
+    }
+    encoderRings[encoderId].dirty = true;
+}
+
+void LEDController::updateRingPower(int encoderId) {
+    // Only the ring just rendered is re-summed, so frame cost does not grow
+    // with the number of unchanged rings
+    EncoderRing& ring = encoderRings[encoderId];
+    uint32_t power = powerSumMapped(leds, &ledMap[ring.mapIndex], ring.ledCount);
+    framePower = framePower - ringPower[encoderId] + power;
+    ringPower[encoderId] = power;
+}
+
+void LEDController::applyPowerLimit(uint32_t power) {
+    uint8_t limited = powerLimitBrightness(power, TOTAL_LEDS, brightness,
+                                           (uint32_t)LED_MAX_VOLTS * LED_MAX_MILLIAMPS);
+    if (limited != output->getBrightness()) {
+        output->setBrightness(limited);
+    }
+}
+
+void LEDController::showFullFrame() {
+    // Diagnostics and test patterns draw outside the ring renderers: every
+    // strip goes out and power is summed in full. Same busy check as the
+    // render path, so these never wait on the output either.
+    pendingStripMask = LED_ALL_STRIPS;
+    fullFramePending = true;
+    pushFrame();
 }
 
 void LEDController::renderOff(int encoderId) {
-    int start = getEncoderStartIndex(encoderId);
-    int end = getEncoderEndIndex(encoderId);
+    EncoderRing& ring = encoderRings[encoderId];
+    CRGB black = CRGB::Black;
+    patternFillSolid(&leds[ring.startIndex], ring.ledCount, black);
+}
+
+void LEDController::renderStream(int encoderId) {
+    EncoderRing& ring = encoderRings[encoderId];
+    const uint16_t* indexMap = &ledMap[ring.mapIndex];
     
-    for (int i = start; i < end; i++) {
-        leds[i] = CRGB::Black;
+    for (int i = 0; i < ring.ledCount; i++) {
+        leds[indexMap[i]] = streamFrame[indexMap[i]];
     }
 }
 
-void LEDController::renderSolid(int encoderId) {
+void LEDController::renderMeter(int encoderId) {
+    EncoderRing& ring = encoderRings[encoderId];
+    const MeterState& meter = meters[encoderId];
+    int activeLEDs = ((uint32_t)meter.level * ring.ledCount + 32767) >> 16;
+    int peakLEDs = ((uint32_t)meter.peak * ring.ledCount + 32767) >> 16;
+    int peakIndex = (peakLEDs > activeLEDs) ? peakLEDs - 1 : -1;
+    
+    patternFillMeter(leds, &ledMap[ring.mapIndex], ring.ledCount, activeLEDs, peakIndex,
+                     ring.color, CRGB(LED_METER_WARN_COLOR), CRGB(LED_METER_CLIP_COLOR),
+                     (LED_METER_WARN_LEVEL * ring.ledCount) / 255, (LED_METER_CLIP_LEVEL * ring.ledCount) / 255);
+}
+
+void LEDController::renderProgram(int encoderId) {
     EncoderRing& ring = encoderRings[encoderId];
-    int start = getEncoderStartIndex(encoderId);
-    int end = getEncoderEndIndex(encoderId);
+    ProgramSample sample = sampleRing(encoderId);
+    int activeLEDs = (sample.level * ring.ledCount + 127) / 255;
+    
+    patternFillRing(leds, &ledMap[ring.mapIndex], ring.ledCount, activeLEDs, CRGB(sample.r, sample.g, sample.b));
     
-    for (int i = start; i < end; i++) {
-        leds[i] = ring.color;
+    // A finished 'once' program holds its last keyframe as a static ring
+    if (sample.finished) {
+        freezeProgram(encoderId, sample);
     }
 }
 
+void LEDController::renderSolid(int encoderId) {
+    EncoderRing& ring = encoderRings[encoderId];
+    patternFillSolid(&leds[ring.startIndex], ring.ledCount, ring.color);
+}
+
 void LEDController::renderRingFill(int encoderId) {
     EncoderRing& ring = encoderRings[encoderId];
-    int start = getEncoderStartIndex(encoderId);
-    int activeLEDs = (int)(ring.value * LEDS_PER_ENCODER);
+    uint32_t position = ((uint32_t)ring.shownValue * ring.ledCount + 128) >> 8;
     
-    for (int i = 0; i < LEDS_PER_ENCODER; i++) {
-        int ledIndex = start + i;
-        if (i < activeLEDs) {
-            leds[ledIndex] = ring.color;
-        } else {
-            // Dim background
-            leds[ledIndex] = CRGB(ring.color.r / 8, ring.color.g / 8, ring.color.b / 8);
-        }
-    }
+    // Active LEDs in full color over a dim background, with the boundary
+    // LED at partial brightness
+    patternFillRingSmooth(leds, &ledMap[ring.mapIndex], ring.ledCount, position, ring.color);
 }
 
 void LEDController::renderPulse(int encoderId) {
     EncoderRing& ring = encoderRings[encoderId];
-    int start = getEncoderStartIndex(encoderId);
-    int end = getEncoderEndIndex(encoderId);
+    patternFillPulse(&leds[ring.startIndex], ring.ledCount, ring.color, ring.animationPhase);
+}
+
+void LEDController::renderRainbow(int encoderId) {
+    EncoderRing& ring = encoderRings[encoderId];
+    patternFillRainbow(leds, &ledMap[ring.mapIndex], ring.ledCount, ring.animationPhase);
+}
+
+void LEDController::applyBatch(const LEDRingUpdate* updates, int count) {
+    // Rings are only staged here; the next frame tick applies them all and
+    // pushes them together
+    for (int i = 0; i < count; i++) {
+        stageRingUpdate(updates[i]);
+    }
+}
+
+void LEDController::stageRingUpdate(const LEDRingUpdate& update) {
+    if (!isValidEncoderId(update.encoderId)) return;
     
-    float pulseValue = getPulseValue(ring.animationPhase);
-    CRGB pulseColor = CRGB(
-        scaleBrightness(ring.color.r, pulseValue),
-        scaleBrightness(ring.color.g, pulseValue),
-        scaleBrightness(ring.color.b, pulseValue)
-    );
+    if (updateStaged[update.encoderId]) {
+        updatesCoalesced++;
+    }
+    stagedUpdates[update.encoderId] = update;
+    updateStaged[update.encoderId] = true;
+    anyUpdateStaged = true;
+}
+
+void LEDController::applyStagedUpdates() {
+    if (!anyUpdateStaged) return;
     
-    for (int i = start; i < end; i++) {
-        leds[i] = pulseColor;
+    for (int i = 0; i < NUM_ENCODERS; i++) {
+        flushStagedUpdate(i);
     }
+    anyUpdateStaged = false;
 }
 
-void LEDController::renderRainbow(int encoderId) {
-    int start = getEncoderStartIndex(encoderId);
+void LEDController::flushStagedUpdate(int encoderId) {
+    // Direct ring changes flush first, so a staged update never lands on
+    // top of something that arrived after it
+    if (!updateStaged[encoderId]) return;
+    
+    const LEDRingUpdate& update = stagedUpdates[encoderId];
+    updateStaged[encoderId] = false;
+    updateEncoderRing(encoderId, update.r, update.g, update.b, update.pattern, update.value);
+}
+
+void LEDController::setMeterLevels(int firstEncoder, const uint8_t* levels, int count) {
+    // Only the target changes here - the bar follows it through the
+    // ballistics on the next frame tick
+    for (int i = 0; i < count; i++) {
+        int encoderId = firstEncoder + i;
+        if (!isValidEncoderId(encoderId)) break;
+        meters[encoderId].target = levels[i] * 257;
+    }
+}
+
+bool LEDController::applyStreamFrame(int target, uint32_t seq, bool keyFrame, const uint8_t* ops, size_t length) {
+    if (target >= NUM_ENCODERS) return false;
+    
+    // The Pi is ahead of the strip by more than its window - drop the frame
+    // and ask for a key frame, since later deltas no longer have a base
+    int count = (target < 0) ? TOTAL_LEDS : encoderRings[target].ledCount;
+    if (streamPending >= LED_STREAM_WINDOW || ops == nullptr || !streamValidate(ops, length, count)) {
+        streamDropped++;
+        streamResync = true;
+        streamAckDue = true;
+        return false;
+    }
+    
+    // A delta needs the frame before it on the strip - after a gap, every
+    // delta is refused until a key frame gives the stream a base again
+    if (!keyFrame && (streamResync || seq != streamSeq + 1)) {
+        streamDropped++;
+        streamResync = true;
+        streamAckDue = true;
+        return false;
+    }
+    streamResync = false;
+    
+    // Whole-strip frames are in strip order, per-ring frames in ring order
+    const uint16_t* indexMap = (target < 0) ? nullptr : &ledMap[encoderRings[target].mapIndex];
+    streamApply(streamFrame, indexMap, ops, length);
+    
+    int first = (target < 0) ? 0 : target;
+    int last = (target < 0) ? NUM_ENCODERS - 1 : target;
+    for (int i = first; i <= last; i++) {
+        flushStagedUpdate(i);
+        encoderRings[i].pattern = PATTERN_STREAM;
+        encoderRings[i].active = true;
+        encoderRings[i].dirty = true;
+    }
+    
+    streamSeq = seq;
+    streamPending++;
+    streamFrames++;
+    return true;
+}
+
+bool LEDController::takeStreamAck(StreamAck& ack) {
+    if (!streamAckDue) return false;
+    
+    ack.seq = streamSeq;
+    ack.credits = LED_STREAM_WINDOW - streamPending;
+    ack.resync = streamResync;
+    ack.dropped = streamDropped;
+    streamAckDue = false;
+    return true;
+}
+
+bool LEDController::loadProgram(int encoderId, const LEDProgram& program, bool start) {
+    if (!isValidEncoderId(encoderId) || program.count == 0 || program.count > LED_PROGRAM_MAX_KEYFRAMES) {
+        return false;
+    }
+    
+    ringPrograms[encoderId].program = program;
+    ringPrograms[encoderId].loaded = true;
+    
+    LOG_INFO("LED", "Program loaded on encoder %d: %d keyframes, %lu ms cycle",
+             encoderId, program.count, (unsigned long)programCycleMs(program));
+    
+    return start ? startProgram(encoderId) : true;
+}
+
+bool LEDController::startProgram(int encoderId) {
+    if (!isValidEncoderId(encoderId) || !ringPrograms[encoderId].loaded) return false;
+    flushStagedUpdate(encoderId);
+    
+    EncoderRing& ring = encoderRings[encoderId];
+    ringPrograms[encoderId].startMicros = micros();
+    ring.pattern = PATTERN_PROGRAM;
+    ring.active = true;
+    ring.lastUpdate = millis();
+    ring.dirty = true;
+    return true;
+}
+
+void LEDController::stopProgram(int encoderId) {
+    if (!isProgramRunning(encoderId)) return;
+    
+    // Hold whatever is on the ring right now
+    freezeProgram(encoderId, sampleRing(encoderId));
+    encoderRings[encoderId].dirty = true;
+}
+
+void LEDController::retargetProgram(int encoderId, const ProgramKeyframe& target) {
+    if (!isValidEncoderId(encoderId)) return;
+    flushStagedUpdate(encoderId);
+    
+    EncoderRing& ring = encoderRings[encoderId];
     
-    for (int i = 0; i < LEDS_PER_ENCODER; i++) {
-        int ledIndex = start + i;
-        float hueOffset = (float)i / LEDS_PER_ENCODER;
-        CRGB rainbowColor = getRainbowColor(encoderRings[encoderId].animationPhase + hueOffset);
-        leds[ledIndex] = rainbowColor;
+    // Start from what the ring shows now so the transition has no jump
+    ProgramKeyframe from;
+    if (ring.pattern == PATTERN_PROGRAM) {
+        ProgramSample sample = sampleRing(encoderId);
+        from.r = sample.r;
+        from.g = sample.g;
+        from.b = sample.b;
+        from.level = sample.level;
+    } else {
+        CRGB color = (ring.pattern == PATTERN_OFF) ? CRGB(CRGB::Black) : ring.color;
+        from.r = color.r;
+        from.g = color.g;
+        from.b = color.b;
+        from.level = (ring.pattern == PATTERN_RING_FILL) ? (uint8_t)(ring.shownValue >> 8) : 255;
     }
+    from.easing = target.easing;
+    from.durationMs = target.durationMs;
+    
+    LEDProgram& program = ringPrograms[encoderId].program;
+    program.keyframes[0] = from;
+    program.keyframes[1] = target;
+    program.count = 2;
+    program.loop = PROGRAM_ONCE;
+    ringPrograms[encoderId].loaded = true;
+    startProgram(encoderId);
+}
+
+bool LEDController::isProgramRunning(int encoderId) const {
+    return isValidEncoderId(encoderId) && encoderRings[encoderId].pattern == PATTERN_PROGRAM;
 }
 
 void LEDController::updateEncoderRing(int encoderId, uint8_t r, uint8_t g, uint8_t b, LEDPattern pattern, float value) {
     if (!isValidEncoderId(encoderId)) return;
+    flushStagedUpdate(encoderId);
     
     EncoderRing& ring = encoderRings[encoderId];
-    ring.color = CRGB(r, g, b);
+    CRGB newColor = CRGB(r, g, b);
+    float newValue = constrain(value, 0.0, 1.0);
+    if (ring.color != newColor || ring.pattern != pattern || ring.value != newValue) {
+        ring.dirty = true;
+    }
+    
+    // A new look fades in over the old one; value changes ease on their own
+    if (ring.active && (ring.color != newColor || ring.pattern != pattern)) {
+        startCrossfade(encoderId);
+    }
+    
+    // Values only ease while the ring stays a ring fill
+    bool tween = (ring.pattern == PATTERN_RING_FILL && pattern == PATTERN_RING_FILL);
+    ring.color = newColor;
     ring.pattern = pattern;
-    ring.value = constrain(value, 0.0, 1.0);
+    setRingValue(ring, newValue, tween);
     ring.active = true;
     ring.lastUpdate = millis();
+}
+
+void LEDController::commitEncoderValue(int encoderId, float value, unsigned long eventMicros) {
+    if (!isValidEncoderId(encoderId)) return;
+    flushStagedUpdate(encoderId);
+    
+    EncoderRing& ring = encoderRings[encoderId];
+    float newValue = constrain(value, 0.0, 1.0);
+    if (ring.pattern == PATTERN_RING_FILL && ring.value == newValue) return;
+    
+    // Local encoder feedback is never eased - it has to be immediate
+    ring.pattern = PATTERN_RING_FILL;
+    ringLayers[encoderId].fading = false;
+    setRingValue(ring, newValue, false);
+    ring.active = true;
+    ring.lastUpdate = millis();
+    ring.dirty = true;
+    
+    // Diagnostics own the strip - the ring is redrawn when they finish
+    if (diag.task != DIAG_NONE) return;
+    
+    ring.commitPending = true;
+    
+    // Latency is measured from the oldest change not yet on the strip
+    if (!latencyPending) {
+        latencyPending = true;
+        latencyEventMicros = eventMicros;
+    }
+    
+    unsigned long currentMicros = micros();
+    if (currentMicros - lastShowMicros >= LED_MIN_SHOW_INTERVAL_US) {
+        commitPendingRings();
+    }
+}
+
+void LEDController::commitPendingRings() {
+    // Only the rings touched by encoders are rendered here; everything
+    // else keeps its normal frame schedule
+    unsigned long renderStart = micros();
+    bool rendered = false;
+    for (int i = 0; i < NUM_ENCODERS; i++) {
+        if (encoderRings[i].commitPending) {
+            renderEncoder(i);
+            encoderRings[i].dirty = false;
+            encoderRings[i].commitPending = false;
+            rendered = true;
+        }
+    }
+    
+    // Nothing new to send - the last commit is still waiting on the output
+    if (!rendered) return;
+
+    histogramRecord(frameStats.render, micros() - renderStart);
+    pushFrame();
+}
+
+void LEDController::pushFrame() {
+    // Never wait on the output from the render path - the finished frame
+    // stays in the buffer and is pushed by the next update()
+    if (output->isBusy()) {
+        framePushPending = true;
+        return;
+    }
+    
+    bool fullFrame = fullFramePending;
+    applyPowerLimit(fullFrame ? powerSum(leds, TOTAL_LEDS) : framePower);
+    
+    // Add small delay before show() for signal stability
+    delayMicroseconds(10);
+    unsigned long showStart = micros();
+    if (!output->show(pendingStripMask)) {
+        framePushPending = true;
+        return;
+    }
+    unsigned long showEnd = micros();
+    markStripsPushed(pendingStripMask);
+    pendingStripMask = 0;
+    framePushPending = false;
+    fullFramePending = false;
     
-    Serial.printf("[LED] Updated encoder %d: RGB(%d,%d,%d) pattern=%d value=%.2f\n", 
-                  encoderId, r, g, b, pattern, value);
+    // Diagnostic and test pattern frames stay out of the frame statistics
+    if (fullFrame) return;
+    
+    histogramRecord(frameStats.show, showEnd - showStart);
+    if (framesRendered > 0) {
+        histogramRecord(frameStats.interval, showEnd - lastShowMicros);
+    }
+    
+    // Stream data is on the strip - return the Pi's credits
+    if (streamPending > 0) {
+        streamSuperseded += streamPending - 1;
+        streamPending = 0;
+        streamAckDue = true;
+    }
+    framesRendered++;
+    
+    lastShowMicros = showEnd;
+    
+    if (latencyPending) {
+        latencyLastUs = lastShowMicros - latencyEventMicros;
+        latencyMaxUs = max(latencyMaxUs, latencyLastUs);
+        latencyTotalUs += latencyLastUs;
+        latencySamples++;
+        latencyPending = false;
+    }
+}
+
+void LEDController::resetEncoderLatency() {
+    // A change still waiting for the strip keeps its start time
+    latencyLastUs = 0;
+    latencyMaxUs = 0;
+    latencyTotalUs = 0;
+    latencySamples = 0;
 }
 
 void LEDController::setEncoderColor(int encoderId, uint8_t r, uint8_t g, uint8_t b) {
     if (!isValidEncoderId(encoderId)) return;
-    encoderRings[encoderId].color = CRGB(r, g, b);
+    flushStagedUpdate(encoderId);
+    EncoderRing& ring = encoderRings[encoderId];
+    CRGB newColor = CRGB(r, g, b);
+    if (ring.color != newColor) {
+        ring.color = newColor;
+        ring.dirty = true;
+    }
 }
 
 void LEDController::setEncoderPattern(int encoderId, LEDPattern pattern) {
     if (!isValidEncoderId(encoderId)) return;
-    encoderRings[encoderId].pattern = pattern;
+    flushStagedUpdate(encoderId);
+    EncoderRing& ring = encoderRings[encoderId];
+    if (ring.pattern != pattern) {
+        ring.pattern = pattern;
+        ring.dirty = true;
+    }
 }
 
 void LEDController::setEncoderValue(int encoderId, float value) {
     if (!isValidEncoderId(encoderId)) return;
-    encoderRings[encoderId].value = constrain(value, 0.0, 1.0);
+    flushStagedUpdate(encoderId);
+    EncoderRing& ring = encoderRings[encoderId];
+    float newValue = constrain(value, 0.0, 1.0);
+    if (ring.value != newValue) {
+        setRingValue(ring, newValue, ring.pattern == PATTERN_RING_FILL);
+        ring.dirty = true;
+    }
 }
 
-void LEDController::setBrightness(uint8_t brightness) {
-    FastLED.setBrightness(brightness);
-    Serial.printf("[LED] Brightness set to %d\n", brightness);
+void LEDController::setBrightness(uint8_t newBrightness) {
+    // Applied (after power limiting) with the next frame
+    brightness = newBrightness;
+    markAllDirty();
+    LOG_INFO("LED", "Brightness set to %d", brightness);
 }
 
 void LEDController::clearAll() {
-    FastLED.clear();
-    FastLED.show();
+    // Leave the strip alone while a diagnostic is drawing on it
+    if (diag.task == DIAG_NONE) {
+        clearBuffer();
+        showFullFrame();
+    }
     
     // Reset all encoder rings
     for (int i = 0; i < NUM_ENCODERS; i++) {
         encoderRings[i].pattern = PATTERN_OFF;
         encoderRings[i].value = 0.0;
+        encoderRings[i].shownValue = 0;
         encoderRings[i].active = false;
+        ringLayers[i].fading = false;
+        updateStaged[i] = false;
+        clearOverlays(i);
     }
+    anyUpdateStaged = false;
 }
 
 void LEDController::showTestPattern() {
@@ -239,12 +796,14 @@ void LEDController::showTestPattern() {
         CRGB::Purple, CRGB::Cyan, CRGB::Orange, CRGB::White
     };
     
+    const int numColors = sizeof(testColors) / sizeof(testColors[0]);
     for (int i = 0; i < NUM_ENCODERS; i++) {
-        updateEncoderRing(i, testColors[i].r, testColors[i].g, testColors[i].b, 
+        const CRGB& color = testColors[i % numColors];
+        updateEncoderRing(i, color.r, color.g, color.b, 
                          PATTERN_RING_FILL, 0.5);
     }
     
-    Serial.println("[LED] Test pattern displayed");
+    LOG_INFO("LED", "Test pattern displayed");
 }
 
 void LEDController::showErrorPattern() {
@@ -252,14 +811,14 @@ void LEDController::showErrorPattern() {
     for (int i = 0; i < NUM_ENCODERS; i++) {
         updateEncoderRing(i, 255, 0, 0, PATTERN_PULSE, 1.0);
     }
-    Serial.println("[LED] Error pattern displayed");
+    LOG_INFO("LED", "Error pattern displayed");
 }
 
 void LEDController::showStartupSequence() {
     // Sequential startup animation
     for (int i = 0; i < NUM_ENCODERS; i++) {
         updateEncoderRing(i, 0, 255, 128, PATTERN_SOLID, 1.0);
-        FastLED.show();
+        showFullFrame();
         delay(100);
         updateEncoderRing(i, 0, 0, 0, PATTERN_OFF, 0.0);
     }
@@ -268,11 +827,11 @@ void LEDController::showStartupSequence() {
     for (int i = 0; i < NUM_ENCODERS; i++) {
         updateEncoderRing(i, 0, 128, 255, PATTERN_SOLID, 1.0);
     }
-    FastLED.show();
+    showFullFrame();
     delay(200);
     
     clearAll();
-    Serial.println("[LED] Startup sequence complete");
+    LOG_INFO("LED", "Startup sequence complete");
 }
 
 void LEDController::simpleColorTest(int step) {
@@ -280,259 +839,620 @@ void LEDController::simpleColorTest(int step) {
     switch(step) {
         case 0:
             // All LEDs OFF
-            Serial.println("[LED] All LEDs OFF");
-            FastLED.clear();
-            FastLED.show();
+            LOG_INFO("LED", "All LEDs OFF");
+            clearBuffer();
+            showFullFrame();
             break;
             
         case 1:
             // First 5 LEDs RED
-            Serial.println("[LED] First 5 LEDs RED");
-            FastLED.clear();
+            LOG_INFO("LED", "First 5 LEDs RED");
+            clearBuffer();
             for(int i = 0; i < 5 && i < TOTAL_LEDS; i++) {
                 leds[i] = CRGB::Red;
             }
-            FastLED.show();
+            showFullFrame();
             break;
             
         case 2:
             // LEDs 5-9 GREEN  
-            Serial.println("[LED] LEDs 5-9 GREEN");
-            FastLED.clear();
+            LOG_INFO("LED", "LEDs 5-9 GREEN");
+            clearBuffer();
             for(int i = 5; i < 10 && i < TOTAL_LEDS; i++) {
                 leds[i] = CRGB::Green;
             }
-            FastLED.show();
+            showFullFrame();
             break;
             
         case 3:
             // LEDs 10-14 BLUE
-            Serial.println("[LED] LEDs 10-14 BLUE");
-            FastLED.clear();
+            LOG_INFO("LED", "LEDs 10-14 BLUE");
+            clearBuffer();
             for(int i = 10; i < 15 && i < TOTAL_LEDS; i++) {
                 leds[i] = CRGB::Blue;
             }
-            FastLED.show();
+            showFullFrame();
             break;
             
         case 4:
             // All LEDs dim white (test if color order is wrong)
-            Serial.println("[LED] All LEDs dim white");
+            LOG_INFO("LED", "All LEDs dim white");
             for(int i = 0; i < TOTAL_LEDS; i++) {
                 leds[i] = CRGB(32, 32, 32);  // Dim white
             }
-            FastLED.show();
+            showFullFrame();
             break;
     }
+    
+    markAllDirty();
 }
 
-// NEW: Comprehensive diagnostic functions
-void LEDController::runFullDiagnostics() {
-    Serial.println("=== LED STRIP DIAGNOSTICS ===");
-    Serial.printf("Configured LEDs: %d\n", TOTAL_LEDS);
-    Serial.printf("Current brightness: %d\n", FastLED.getBrightness());
-    Serial.printf("LED Type: APA102, Pins: DATA=%d, CLOCK=%d\n", LED_DATA_PIN, LED_CLOCK_PIN);
+// ============================================================================
+// Diagnostics
+// Each diagnostic is a resumable state machine advanced by update(), so the
+// main loop (UART, heartbeats, encoders) keeps running while it plays out.
+// ============================================================================
+
+bool LEDController::runFullDiagnostics() {
+    if (!startDiagnostic(DIAG_FULL, 0)) return false;
     
-    // Test 1: Clear all
-    Serial.println("\nTest 1: Clear all LEDs");
-    FastLED.clear();
-    FastLED.show();
-    delay(1000);
+    LOG_INFO("LED", "=== LED STRIP DIAGNOSTICS ===");
+    LOG_INFO("LED", "Configured LEDs: %d", TOTAL_LEDS);
+    LOG_INFO("LED", "Current brightness: %d", output->getBrightness());
+    LOG_INFO("LED", "Output backend: %s", output->getName());
+    return true;
+}
+
+void LEDController::testLEDRange(int startLED, int endLED, CRGB color) {
+    clearBuffer();
+    LOG_INFO("LED", "Testing LEDs %d to %d with color RGB(%d,%d,%d)",
+             startLED, endLED-1, color.r, color.g, color.b);
     
-    // Test 2: Single LED sweep
-    Serial.println("Test 2: Single LED sweep (first 20)");
-    for(int i = 0; i < min(20, TOTAL_LEDS); i++) {
-        FastLED.clear();
-        leds[i] = CRGB::Red;
-        FastLED.show();
-        Serial.printf("LED %d ON\n", i);
-        delay(200);
+    for(int i = startLED; i < endLED && i < TOTAL_LEDS; i++) {
+        leds[i] = color;
     }
-    FastLED.clear();
-    FastLED.show();
+    showFullFrame();
+    markAllDirty();
+}
+
+bool LEDController::sequentialTest(int delayMs) {
+    if (!startDiagnostic(DIAG_SEQUENTIAL, delayMs)) return false;
     
-    // Test 3: Range tests
-    Serial.println("Test 3: Range tests");
-    testLEDRange(0, 10, CRGB::Green);
-    delay(1000);
-    testLEDRange(10, 20, CRGB::Blue);
-    delay(1000);
-    testLEDRange(20, 30, CRGB::Yellow);
-    delay(1000);
+    LOG_INFO("LED", "Sequential LED test starting...");
+    return true;
+}
+
+bool LEDController::findLEDCount() {
+    if (!startDiagnostic(DIAG_FIND_COUNT, 0)) return false;
     
-    // Test 4: Auto-detect strip length
-    Serial.println("Test 4: Auto-detecting strip length...");
-    findLEDCount();
+    LOG_INFO("LED", "Auto-detecting actual LED strip length...");
+    // Method: Light up LEDs one by one and assume user will report last working one
+    LOG_INFO("LED", "Watch your strip and note the LAST LED that lights up correctly");
+    LOG_INFO("LED", "(Ignore any that flash white or act strange)");
+    return true;
+}
+
+bool LEDController::testSignalIntegrity() {
+    if (!startDiagnostic(DIAG_SIGNAL_INTEGRITY, 0)) return false;
     
-    Serial.println("=== DIAGNOSTICS COMPLETE ===");
+    LOG_INFO("LED", "=== SIGNAL INTEGRITY TEST ===");
+    LOG_INFO("LED", "This test checks for level shifting and communication issues");
+    LOG_INFO("LED", "Watch for: bright flashes, color corruption, or unstable behavior");
+    return true;
 }
 
-void LEDController::testLEDRange(int startLED, int endLED, CRGB color) {
-    FastLED.clear();
-    Serial.printf("Testing LEDs %d to %d with color RGB(%d,%d,%d)\n", 
-                  startLED, endLED-1, color.r, color.g, color.b);
+void LEDController::cancelDiagnostics() {
+    if (diag.task == DIAG_NONE) return;
     
-    for(int i = startLED; i < endLED && i < TOTAL_LEDS; i++) {
-        leds[i] = color;
+    LOG_INFO("LED", "Diagnostic '%s' cancelled at step %d/%d",
+             getDiagnosticName(), diag.stepsDone, diag.totalSteps);
+    finishDiagnostic();
+}
+
+const char* LEDController::getDiagnosticName() const {
+    switch (diag.task) {
+        case DIAG_FULL:             return "full";
+        case DIAG_SEQUENTIAL:       return "sequential";
+        case DIAG_FIND_COUNT:       return "find_led_count";
+        case DIAG_SIGNAL_INTEGRITY: return "signal_integrity";
+        default:                    return "none";
     }
-    FastLED.show();
 }
 
-void LEDController::sequentialTest(int delayMs) {
-    Serial.println("Sequential LED test starting...");
-    FastLED.clear();
+int LEDController::getDiagnosticProgress() const {
+    if (diag.task == DIAG_NONE || diag.totalSteps <= 0) return 0;
+    return (diag.stepsDone * 100) / diag.totalSteps;
+}
+
+bool LEDController::startDiagnostic(DiagnosticTask task, int delayMs) {
+    if (diag.task != DIAG_NONE) {
+        LOG_WARN("LED", "Diagnostic '%s' already running", getDiagnosticName());
+        return false;
+    }
     
-    for(int i = 0; i < TOTAL_LEDS; i++) {
-        leds[i] = CRGB(255, 0, 0); // Red
-        FastLED.show();
-        Serial.printf("LED %d\n", i);
-        delay(delayMs);
-        
-        // Also turn on as green to make a trail
-        if(i > 0) leds[i-1] = CRGB(0, 128, 0);
+    int sweepCount = min(20, TOTAL_LEDS);
+    int findCountSteps = TOTAL_LEDS * 2 + 1;
+    
+    diag.task = task;
+    diag.stage = 0;
+    diag.index = 0;
+    diag.delayMs = delayMs;
+    diag.stepsDone = 0;
+    diag.nextStepAt = millis();
+    
+    switch (task) {
+        case DIAG_FULL:
+            diag.totalSteps = 1 + sweepCount + 3 + findCountSteps;
+            break;
+        case DIAG_SEQUENTIAL:
+            diag.totalSteps = TOTAL_LEDS + 1;
+            break;
+        case DIAG_FIND_COUNT:
+            diag.totalSteps = findCountSteps;
+            break;
+        case DIAG_SIGNAL_INTEGRITY:
+            diag.totalSteps = 2 + 20 + sweepCount + 1;
+            break;
+        default:
+            diag.totalSteps = 0;
+            break;
     }
     
-    delay(1000);
-    FastLED.clear();
-    FastLED.show();
-    Serial.println("Sequential test complete");
+    clearBuffer();
+    return true;
 }
 
-void LEDController::findLEDCount() {
-    Serial.println("Auto-detecting actual LED strip length...");
-    FastLED.clear();
+void LEDController::finishDiagnostic() {
+    diag.task = DIAG_NONE;
+    clearBuffer();
+    showFullFrame();
     
-    // Method: Light up LEDs one by one and assume user will report last working one
-    Serial.println("Watch your strip and note the LAST LED that lights up correctly");
-    Serial.println("(Ignore any that flash white or act strange)");
+    // Diagnostics drew straight into the strip - restore ring output
+    markAllDirty();
+}
+
+void LEDController::updateDiagnostic() {
+    unsigned long currentTime = millis();
+    if ((long)(currentTime - diag.nextStepAt) < 0) return;
     
-    for(int i = 0; i < TOTAL_LEDS; i++) {
-        FastLED.clear();
-        leds[i] = CRGB::Blue;
-        FastLED.show();
-        
-        Serial.printf("Testing LED %d - Is this LED working properly? (Press any key to continue)\n", i);
-        delay(500);
-        
-        // Light up all previous LEDs dimly to show progress
-        for(int j = 0; j <= i; j++) {
-            leds[j] = CRGB(0, 0, 64); // Dim blue
-        }
-        leds[i] = CRGB::Blue; // Current LED bright
-        FastLED.show();
-        delay(1000);
+    unsigned long waitMs = 0;
+    bool done = false;
+    
+    switch (diag.task) {
+        case DIAG_FULL:
+            done = stepFullDiagnostics(waitMs);
+            break;
+        case DIAG_SEQUENTIAL:
+            done = stepSequentialTest(waitMs);
+            break;
+        case DIAG_FIND_COUNT:
+            done = stepFindLEDCount(waitMs);
+            break;
+        case DIAG_SIGNAL_INTEGRITY:
+            done = stepSignalIntegrity(waitMs);
+            break;
+        default:
+            done = true;
+            break;
     }
     
-    FastLED.clear();
-    FastLED.show();
-    Serial.println("Auto-detection complete. Please update LEDS_PER_ENCODER in config.h with the correct count.");
+    diag.stepsDone++;
+    
+    if (done) {
+        finishDiagnostic();
+    } else {
+        diag.nextStepAt = currentTime + waitMs;
+    }
 }
 
-void LEDController::testSignalIntegrity() {
-    Serial.println("=== SIGNAL INTEGRITY TEST ===");
-    Serial.println("This test checks for level shifting and communication issues");
-    Serial.println("Watch for: bright flashes, color corruption, or unstable behavior");
+bool LEDController::stepFullDiagnostics(unsigned long& waitMs) {
+    const int sweepCount = min(20, TOTAL_LEDS);
     
-    // Test 1: Static patterns (should be rock solid)
-    Serial.println("Test 1: Static red pattern (should be stable)");
-    FastLED.clear();
-    for(int i = 0; i < TOTAL_LEDS; i++) {
-        leds[i] = CRGB(128, 0, 0); // Medium red
+    switch (diag.stage) {
+        case 0:
+            // Test 1: Clear all
+            LOG_INFO("LED", "Test 1: Clear all LEDs");
+            clearBuffer();
+            showFullFrame();
+            diag.stage = 1;
+            diag.index = 0;
+            waitMs = 1000;
+            return false;
+            
+        case 1:
+            // Test 2: Single LED sweep
+            if (diag.index == 0) {
+                LOG_INFO("LED", "Test 2: Single LED sweep (first 20)");
+            }
+            clearBuffer();
+            leds[diag.index] = CRGB::Red;
+            showFullFrame();
+            LOG_DEBUG("LED", "LED %d ON", diag.index);
+            
+            if (++diag.index >= sweepCount) {
+                diag.stage = 2;
+                diag.index = 0;
+            }
+            waitMs = 200;
+            return false;
+            
+        case 2: {
+            // Test 3: Range tests
+            static const CRGB rangeColors[] = { CRGB::Green, CRGB::Blue, CRGB::Yellow };
+            if (diag.index == 0) {
+                LOG_INFO("LED", "Test 3: Range tests");
+            }
+            testLEDRange(diag.index * 10, diag.index * 10 + 10, rangeColors[diag.index]);
+            
+            if (++diag.index >= 3) {
+                diag.stage = 3;
+                diag.index = 0;
+            }
+            waitMs = 1000;
+            return false;
+        }
+            
+        default:
+            // Test 4: Auto-detect strip length
+            if (diag.stage == 3) {
+                LOG_INFO("LED", "Test 4: Auto-detecting strip length...");
+                diag.stage = 4;
+                diag.index = 0;
+            }
+            if (stepFindLEDCount(waitMs)) {
+                LOG_INFO("LED", "=== DIAGNOSTICS COMPLETE ===");
+                return true;
+            }
+            return false;
     }
-    FastLED.show();
-    delay(3000);
+}
+
+bool LEDController::stepSequentialTest(unsigned long& waitMs) {
+    if (diag.index >= TOTAL_LEDS) {
+        LOG_INFO("LED", "Sequential test complete");
+        return true;
+    }
+    
+    // Turn the previous LED green to make a trail
+    if (diag.index > 0) leds[diag.index - 1] = CRGB(0, 128, 0);
     
-    // Test 2: Alternating pattern (tests data integrity)
-    Serial.println("Test 2: Alternating red/blue pattern");
-    for(int i = 0; i < TOTAL_LEDS; i++) {
-        leds[i] = (i % 2 == 0) ? CRGB(128, 0, 0) : CRGB(0, 0, 128);
+    leds[diag.index] = CRGB(255, 0, 0); // Red
+    showFullFrame();
+    LOG_DEBUG("LED", "LED %d", diag.index);
+    
+    diag.index++;
+    
+    // Hold the finished trail for a second before clearing
+    waitMs = (diag.index >= TOTAL_LEDS) ? diag.delayMs + 1000 : diag.delayMs;
+    return false;
+}
+
+bool LEDController::stepFindLEDCount(unsigned long& waitMs) {
+    // Two steps per LED: flash it alone, then show progress up to it
+    int led = diag.index / 2;
+    
+    if (led >= TOTAL_LEDS) {
+        LOG_INFO("LED", "Auto-detection complete. Please update TOTAL_LEDS in config.h and ring_layout.h with the correct count.");
+        return true;
     }
-    FastLED.show();
-    delay(3000);
     
-    // Test 3: Rapid updates (stress test)
-    Serial.println("Test 3: Rapid color changes (stress test)");
-    for(int cycle = 0; cycle < 20; cycle++) {
-        CRGB colors[] = {CRGB::Red, CRGB::Green, CRGB::Blue, CRGB::Black};
-        for(int i = 0; i < TOTAL_LEDS; i++) {
-            leds[i] = colors[cycle % 4];
+    if ((diag.index % 2) == 0) {
+        clearBuffer();
+        leds[led] = CRGB::Blue;
+        showFullFrame();
+        LOG_DEBUG("LED", "Testing LED %d - Is this LED working properly?", led);
+        waitMs = 500;
+    } else {
+        // Light up all previous LEDs dimly to show progress
+        for (int j = 0; j <= led; j++) {
+            leds[j] = CRGB(0, 0, 64); // Dim blue
         }
-        FastLED.show();
-        delay(100);
+        leds[led] = CRGB::Blue; // Current LED bright
+        showFullFrame();
+        waitMs = 1000;
     }
     
-    // Test 4: Individual LED addressing
-    Serial.println("Test 4: Individual LED sweep");
-    FastLED.clear();
-    for(int i = 0; i < min(20, TOTAL_LEDS); i++) {
-        FastLED.clear();
-        leds[i] = CRGB::White;
-        FastLED.show();
-        delay(200);
+    diag.index++;
+    return false;
+}
+
+bool LEDController::stepSignalIntegrity(unsigned long& waitMs) {
+    const int sweepCount = min(20, TOTAL_LEDS);
+    
+    switch (diag.stage) {
+        case 0:
+            // Test 1: Static patterns (should be rock solid)
+            LOG_INFO("LED", "Test 1: Static red pattern (should be stable)");
+            for (int i = 0; i < TOTAL_LEDS; i++) {
+                leds[i] = CRGB(128, 0, 0); // Medium red
+            }
+            showFullFrame();
+            diag.stage = 1;
+            waitMs = 3000;
+            return false;
+            
+        case 1:
+            // Test 2: Alternating pattern (tests data integrity)
+            LOG_INFO("LED", "Test 2: Alternating red/blue pattern");
+            for (int i = 0; i < TOTAL_LEDS; i++) {
+                leds[i] = (i % 2 == 0) ? CRGB(128, 0, 0) : CRGB(0, 0, 128);
+            }
+            showFullFrame();
+            diag.stage = 2;
+            diag.index = 0;
+            waitMs = 3000;
+            return false;
+            
+        case 2: {
+            // Test 3: Rapid updates (stress test)
+            static const CRGB colors[] = { CRGB::Red, CRGB::Green, CRGB::Blue, CRGB::Black };
+            if (diag.index == 0) {
+                LOG_INFO("LED", "Test 3: Rapid color changes (stress test)");
+            }
+            for (int i = 0; i < TOTAL_LEDS; i++) {
+                leds[i] = colors[diag.index % 4];
+            }
+            showFullFrame();
+            
+            if (++diag.index >= 20) {
+                diag.stage = 3;
+                diag.index = 0;
+            }
+            waitMs = 100;
+            return false;
+        }
+            
+        case 3:
+            // Test 4: Individual LED addressing
+            if (diag.index == 0) {
+                LOG_INFO("LED", "Test 4: Individual LED sweep");
+            }
+            clearBuffer();
+            leds[diag.index] = CRGB::White;
+            showFullFrame();
+            
+            if (++diag.index >= sweepCount) {
+                diag.stage = 4;
+            }
+            waitMs = 200;
+            return false;
+            
+        default:
+            LOG_INFO("LED", "=== SIGNAL INTEGRITY TEST COMPLETE ===");
+            LOG_INFO("LED", "If you saw flashes, corruption, or instability, you likely need:");
+            LOG_INFO("LED", "1. Level shifter (74HCT245 or 74AHCT125)");
+            LOG_INFO("LED", "2. Better power supply");
+            LOG_INFO("LED", "3. Shorter/better wiring");
+            return true;
     }
+}
+
+// Utility functions
+void LEDController::updateAnimationPhases(unsigned long currentMicros) {
+    // Convert elapsed time to 16-bit phase steps (65536 per animation period),
+    // carrying the remainder so slow or late frames never drift
+    unsigned long elapsed = currentMicros - lastAnimationMicros;
+    lastAnimationMicros = currentMicros;
+    
+    uint64_t scaled = (uint64_t)elapsed * 65536 + animationRemainder;
+    uint16_t phaseStep = (uint16_t)(scaled / LED_ANIMATION_PERIOD_US);
+    animationRemainder = (uint32_t)(scaled % LED_ANIMATION_PERIOD_US);
     
-    FastLED.clear();
-    FastLED.show();
+    for (int i = 0; i < NUM_ENCODERS; i++) {
+        // 16-bit phase wraps naturally at the end of each cycle
+        encoderRings[i].animationPhase += phaseStep;
+        
+        // Animated and crossfading rings change every frame; static rings
+        // only on state changes
+        if (isAnimatedPattern(encoderRings[i].pattern) || ringLayers[i].fading) {
+            encoderRings[i].dirty = true;
+        }
+    }
     
-    Serial.println("=== SIGNAL INTEGRITY TEST COMPLETE ===");
-    Serial.println("If you saw flashes, corruption, or instability, you likely need:");
-    Serial.println("1. Level shifter (74HCT245 or 74AHCT125)");
-    Serial.println("2. Better power supply");
-    Serial.println("3. Shorter/better wiring");
+    updateMeters(elapsed, currentMicros);
+    updateValueTweens(elapsed);
 }
 
-// Utility functions
-void LEDController::updateAnimationPhases() {
-    float timeIncrement = 0.02; // Adjust for animation speed
+void LEDController::updateValueTweens(unsigned long elapsedUs) {
+    // Exponential ease toward the target: each frame covers
+    // elapsed / (elapsed + LED_VALUE_TWEEN_US) of the remaining distance.
+    // A tween starts mid-interval, so the first step after an idle frame
+    // must not count the whole idle period.
+    elapsedUs = min(elapsedUs, (unsigned long)LED_FRAME_US_INTERACTIVE);
+    uint32_t alpha = (uint32_t)(((uint64_t)elapsedUs << 16) / (elapsedUs + LED_VALUE_TWEEN_US + 1));
     
     for (int i = 0; i < NUM_ENCODERS; i++) {
-        encoderRings[i].animationPhase += timeIncrement;
-        if (encoderRings[i].animationPhase > 1.0) {
-            encoderRings[i].animationPhase -= 1.0;
+        EncoderRing& ring = encoderRings[i];
+        if (!isTweening(ring)) continue;
+        
+        int32_t target = (int32_t)(ring.value * 65535);
+        int32_t diff = target - ring.shownValue;
+        int32_t step = (int32_t)(((int64_t)diff * alpha) >> 16);
+        
+        // The exponential tail is invisible - finish once within 1/1024
+        if (abs(diff) <= 64 || step == 0) {
+            ring.shownValue = target;
+        } else {
+            ring.shownValue += step;
         }
+        ring.dirty = true;
     }
 }
 
-float LEDController::getPulseValue(float phase) {
-    // Sine wave pulse between 0.1 and 1.0
-    return 0.1 + 0.9 * (sin(phase * 2 * PI) + 1) / 2;
+void LEDController::setRingValue(EncoderRing& ring, float value, bool tween) {
+    ring.value = value;
+    if (!tween || LED_VALUE_TWEEN_US == 0) {
+        ring.shownValue = (uint16_t)(value * 65535);
+    }
 }
 
-CRGB LEDController::getRainbowColor(float phase) {
-    // Convert phase to HSV and then to RGB
-    while (phase > 1.0) phase -= 1.0;
-    while (phase < 0.0) phase += 1.0;
-    
-    CHSV hsv(phase * 255, 255, 255);
-    CRGB rgb;
-    hsv2rgb_rainbow(hsv, rgb);
-    return rgb;
+bool LEDController::isTweening(const EncoderRing& ring) const {
+    return ring.pattern == PATTERN_RING_FILL && ring.shownValue != (uint16_t)(ring.value * 65535);
 }
 
-int LEDController::getEncoderStartIndex(int encoderId) const {
-    return encoderId * LEDS_PER_ENCODER;
+void LEDController::updateMeters(unsigned long elapsedUs, unsigned long currentMicros) {
+    uint32_t barFall = min((uint64_t)elapsedUs * 65535 / LED_METER_DECAY_US, (uint64_t)65535);
+    uint32_t peakFall = min((uint64_t)elapsedUs * 65535 / LED_METER_PEAK_DECAY_US, (uint64_t)65535);
+    
+    for (int i = 0; i < NUM_ENCODERS; i++) {
+        MeterState& meter = meters[i];
+        uint16_t oldLevel = meter.level;
+        uint16_t oldPeak = meter.peak;
+        
+        // Instant attack, linear release
+        if (meter.target >= meter.level) {
+            meter.level = meter.target;
+        } else {
+            meter.level = max((int32_t)meter.target, (int32_t)meter.level - (int32_t)barFall);
+        }
+        
+        // Peak holds, then falls back towards the bar
+        if (meter.level >= meter.peak) {
+            meter.peak = meter.level;
+            meter.peakMicros = currentMicros;
+        } else if (currentMicros - meter.peakMicros >= LED_METER_PEAK_HOLD_US) {
+            meter.peak = max((int32_t)meter.level, (int32_t)meter.peak - (int32_t)peakFall);
+        }
+        
+        // Meters only redraw when the bar or peak actually moved
+        if (encoderRings[i].pattern == PATTERN_METER && (meter.level != oldLevel || meter.peak != oldPeak)) {
+            encoderRings[i].dirty = true;
+        }
+    }
 }
 
-int LEDController::getEncoderEndIndex(int encoderId) const {
-    return (encoderId + 1) * LEDS_PER_ENCODER;
+void LEDController::buildRingLayout() {
+    // Precompute logical -> strip index for every ring so renderers never
+    // deal with rotation or direction per frame
+    int mapIndex = 0;
+    
+    for (int i = 0; i < NUM_ENCODERS; i++) {
+        const RingGeometry& geometry = RING_LAYOUT[i];
+        EncoderRing& ring = encoderRings[i];
+        int count = geometry.count;
+        
+        // Find the strip output this ring sits on
+        int strip = -1;
+        for (int s = 0; s < LED_STRIP_COUNT; s++) {
+            const StripGeometry& stripGeometry = STRIP_LAYOUT[s];
+            if (geometry.start >= stripGeometry.start &&
+                geometry.start + count <= stripGeometry.start + stripGeometry.count) {
+                strip = s;
+                break;
+            }
+        }
+        
+        // Rings that don't fit on one strip (or in the map) are dropped
+        if (strip < 0 || geometry.start + count > TOTAL_LEDS || mapIndex + count > TOTAL_LEDS) {
+            LOG_WARN("LED", "Ring %d does not fit on a strip output - disabled", i);
+            count = 0;
+            strip = 0;
+        }
+        
+        ring.startIndex = geometry.start;
+        ring.ledCount = count;
+        ring.mapIndex = mapIndex;
+        ring.strip = strip;
+        
+        for (int led = 0; led < count; led++) {
+            int offset = geometry.reversed ? (geometry.rotation - led) : (geometry.rotation + led);
+            offset = ((offset % count) + count) % count;
+            ledMap[mapIndex + led] = geometry.start + offset;
+        }
+        
+        mapIndex += count;
+    }
+    
+    LOG_INFO("LED", "Ring layout: %d rings, %d mapped LEDs", NUM_ENCODERS, mapIndex);
 }
 
 bool LEDController::isValidEncoderId(int encoderId) const {
     return encoderId >= 0 && encoderId < NUM_ENCODERS;
 }
 
-CRGB LEDController::blendColors(CRGB color1, CRGB color2, float ratio) {
-    ratio = constrain(ratio, 0.0, 1.0);
-    return CRGB(
-        color1.r * (1 - ratio) + color2.r * ratio,
-        color1.g * (1 - ratio) + color2.g * ratio,
-        color1.b * (1 - ratio) + color2.b * ratio
-    );
+unsigned long LEDController::getFrameIntervalUs() const {
+    unsigned long interval = LED_FRAME_US_IDLE;
+    
+    // Staged ring updates go out at the interactive rate
+    if (anyUpdateStaged) {
+        return LED_FRAME_US_INTERACTIVE;
+    }
+    
+    for (int i = 0; i < NUM_ENCODERS; i++) {
+        // Pending changes and easing values go out at the interactive rate
+        if (encoderRings[i].dirty || isTweening(encoderRings[i])) {
+            return LED_FRAME_US_INTERACTIVE;
+        }
+        
+        unsigned long patternInterval = getPatternFrameIntervalUs(encoderRings[i].pattern);
+        if (patternInterval > 0 && patternInterval < interval) {
+            interval = patternInterval;
+        }
+        if (ringLayers[i].fading && LED_FRAME_US_CROSSFADE < interval) {
+            interval = LED_FRAME_US_CROSSFADE;
+        }
+    }
+    
+    return interval;
+}
+
+unsigned long LEDController::getPatternFrameIntervalUs(LEDPattern pattern) const {
+    switch (pattern) {
+        case PATTERN_PULSE:
+        case PATTERN_ERROR:
+            return LED_FRAME_US_PULSE;
+        case PATTERN_RAINBOW:
+            return LED_FRAME_US_RAINBOW;
+        case PATTERN_PROGRAM:
+            return LED_FRAME_US_PROGRAM;
+        case PATTERN_METER:
+            return LED_FRAME_US_METER;
+        default:
+            return 0; // Static - only redrawn when changed
+    }
+}
+
+bool LEDController::isAnimatedPattern(LEDPattern pattern) const {
+    return pattern == PATTERN_PULSE || pattern == PATTERN_RAINBOW || pattern == PATTERN_ERROR ||
+           pattern == PATTERN_PROGRAM;
+}
+
+void LEDController::clearBuffer() {
+    for (int i = 0; i < TOTAL_LEDS; i++) {
+        leds[i] = CRGB::Black;
+    }
 }
 
-uint8_t LEDController::scaleBrightness(uint8_t value, float scale) {
-    scale = constrain(scale, 0.0, 1.0);
-    return (uint8_t)(value * scale);
+ProgramSample LEDController::sampleRing(int encoderId) {
+    RingProgram& ringProgram = ringPrograms[encoderId];
+    
+    // Rings started after this frame began sit at the first keyframe
+    unsigned long elapsedUs = frameMicros - ringProgram.startMicros;
+    if ((long)elapsedUs < 0) elapsedUs = 0;
+    
+    // Keep looping programs within one cycle of their start so elapsed time
+    // never approaches the micros() wrap
+    unsigned long cycleUs = programCycleMs(ringProgram.program) * 1000UL;
+    if (ringProgram.program.loop != PROGRAM_ONCE && cycleUs > 0 && elapsedUs >= cycleUs) {
+        unsigned long wholeCycles = elapsedUs / cycleUs;
+        ringProgram.startMicros += wholeCycles * cycleUs;
+        elapsedUs -= wholeCycles * cycleUs;
+    }
+    
+    return programEvaluate(ringProgram.program, elapsedUs / 1000);
+}
+
+void LEDController::freezeProgram(int encoderId, const ProgramSample& sample) {
+    EncoderRing& ring = encoderRings[encoderId];
+    ring.color = CRGB(sample.r, sample.g, sample.b);
+    setRingValue(ring, sample.level / 255.0f, false);
+    ring.pattern = PATTERN_RING_FILL;
+}
+
+void LEDController::markAllDirty() {
+    for (int i = 0; i < NUM_ENCODERS; i++) {
+        encoderRings[i].dirty = true;
+    }
 }
 
 CRGB LEDController::getEncoderColor(int encoderId) const {
@@ -4,32 +4,146 @@
 #include <Arduino.h>
 #include <FastLED.h>
 #include "config.h"
+#include "pattern_kernels.h"
+#include "led_output.h"
+#include "ring_layout.h"
+#include "led_program.h"
+#include "led_stream.h"
+#include "led_scaling.h"
+#include "led_stats.h"
 
 // ============================================================================
 // LED Controller for APA102 Strips
-// Manages 8 encoder rings with 28 LEDs each
+// Manages up to 16 encoder rings laid out per ring_layout.h
+// Renders into a local frame buffer; output goes through an LEDOutput backend
 // ============================================================================
 
+struct RingProgram {
+    LEDProgram program;      // Uploaded keyframes
+    unsigned long startMicros; // micros() the program was (re)started
+    bool loaded;             // A program has been uploaded for this ring
+};
+
+struct MeterState {
+    uint16_t target;         // Last level received (0-65535)
+    uint16_t level;          // Displayed bar level after ballistics
+    uint16_t peak;           // Peak-hold level
+    unsigned long peakMicros; // micros() the peak was last raised
+};
+
+struct RingLayers {
+    LEDOverlay overlays[LED_OVERLAY_MAX]; // Drawn over the base pattern
+    unsigned long fadeStartMicros; // micros() the crossfade began
+    bool fading;             // Base pattern is fading in over fadeFrom
+};
+
 struct EncoderRing {
-    int startIndex;          // Starting LED index for this encoder
+    int startIndex;          // First strip LED of this ring
+    int ledCount;            // LEDs in this ring
+    int mapIndex;            // Offset of this ring's entries in ledMap
+    int strip;               // Strip output carrying this ring
     CRGB color;             // Current color
     LEDPattern pattern;     // Current pattern
     float value;            // Current value (0.0 - 1.0)
+    uint16_t shownValue;    // Fill level on the ring (0-65535), eases toward value
     bool active;            // Is this encoder ring active?
     unsigned long lastUpdate; // Last update time for animations
-    float animationPhase;   // Animation phase for pulse/rainbow effects
+    uint16_t animationPhase; // Animation phase for pulse/rainbow (65536 = one cycle)
+    bool dirty;             // Needs re-render on the next frame
+    bool commitPending;     // Encoder change waiting for the fast path
+};
+
+enum DiagnosticTask {
+    DIAG_NONE,
+    DIAG_FULL,
+    DIAG_SEQUENTIAL,
+    DIAG_FIND_COUNT,
+    DIAG_SIGNAL_INTEGRITY
+};
+
+struct DiagnosticState {
+    DiagnosticTask task;     // Diagnostic currently running (DIAG_NONE if idle)
+    int stage;               // Sub-test within the diagnostic
+    int index;               // LED / cycle counter within the stage
+    int delayMs;             // Step delay requested by the caller
+    int stepsDone;           // Steps completed so far (for progress)
+    int totalSteps;          // Total steps the diagnostic will take
+    unsigned long nextStepAt; // millis() when the next step is due
+};
+
+// Flow-control feedback for pixel streaming, sent once stream data is on the strip
+struct StreamAck {
+    uint32_t seq;            // Last stream frame applied
+    int credits;             // Frames the Pi may send before the next ack
+    bool resync;             // Delta base lost - the next frame must be a key frame
+    unsigned long dropped;   // Frames rejected since streaming began
 };
 
 class LEDController {
 private:
     CRGB leds[TOTAL_LEDS];
+    uint16_t ledMap[TOTAL_LEDS];  // Logical ring LED -> strip index, built from RING_LAYOUT
+    LEDOutput* output;
     EncoderRing encoderRings[NUM_ENCODERS];
-    unsigned long lastFrameUpdate;
+    RingProgram ringPrograms[NUM_ENCODERS];
+    MeterState meters[NUM_ENCODERS];
+    RingLayers ringLayers[NUM_ENCODERS];
+    CRGB fadeFrom[TOTAL_LEDS];         // Ring pixels when their crossfade began, strip order
+    unsigned long frameMicros;         // micros() of the frame being rendered
+    
+    // Ring updates from the Pi, held until the next frame - only the last
+    // one per ring is ever shown
+    LEDRingUpdate stagedUpdates[NUM_ENCODERS];
+    bool updateStaged[NUM_ENCODERS];
+    bool anyUpdateStaged;
+    unsigned long updatesCoalesced;    // Staged updates replaced before their frame
+    
+    // Power budget - per-ring sums kept as rings render (led_scaling.h)
+    uint8_t brightness;                // Requested brightness before power limiting
+    uint32_t ringPower[NUM_ENCODERS];
+    uint32_t framePower;
+    
+    // Pixel streaming - last streamed frame in strip order
+    CRGB streamFrame[TOTAL_LEDS];
+    uint32_t streamSeq;                // One sequence for every target (see README led_stream)
+    int streamPending;                 // Stream frames applied but not yet on the strip
+    bool streamAckDue;
+    bool streamResync;
+    unsigned long streamFrames;
+    unsigned long streamDropped;
+    unsigned long streamSuperseded;    // Applied but replaced before reaching the strip
+    unsigned long lastFrameMicros;     // micros() of the last frame tick
+    unsigned long lastAnimationMicros; // micros() the animation clock last advanced
+    uint32_t animationRemainder;       // Sub-step remainder carried between frames
+    unsigned long lastShowMicros;      // micros() of the last strip push
+    uint32_t pendingStripMask;         // Strips with rendered but unpushed changes
+    bool framePushPending;             // Rendered frame waiting for a busy output
+    bool fullFramePending;             // Pending frame was drawn by showFullFrame()
+    unsigned long stripPushMillis[LED_STRIP_COUNT]; // millis() of each strip's last write
+    
+    // Integrity refresh cost
+    unsigned long refreshCount;
+    unsigned long refreshTotalUs;      // Strip transfer time spent on refreshes
+    
+    // Encoder-to-LED latency (event to frame handed to the output)
+    bool latencyPending;
+    unsigned long latencyEventMicros;
+    unsigned long latencyLastUs;
+    unsigned long latencyMaxUs;
+    unsigned long latencyTotalUs;
+    unsigned long latencySamples;
     bool initialized;
+    DiagnosticState diag;
+    
+    // Frame statistics
+    unsigned long framesRendered;
+    unsigned long framesSkipped;
+    LEDFrameStats frameStats;
+    unsigned long lastUpdateMicros;    // micros() of the last update() call
 
 public:
-    // Initialization
-    void begin();
+    // Initialization - frames are pushed through the given output backend
+    void begin(LEDOutput& ledOutput);
     
     // Main update (call in main loop)
     void update();
@@ -40,25 +154,81 @@ public:
     void setEncoderValue(int encoderId, float value);
     void updateEncoderRing(int encoderId, uint8_t r, uint8_t g, uint8_t b, LEDPattern pattern, float value);
     
+    // Stage a ring update for the next frame; a later update for the same
+    // ring replaces it (last writer wins)
+    void stageRingUpdate(const LEDRingUpdate& update);
+    
+    // Apply several ring updates so they all appear in the same frame
+    void applyBatch(const LEDRingUpdate* updates, int count);
+    
+    // Keyframe programs - uploaded once, then played locally
+    bool loadProgram(int encoderId, const LEDProgram& program, bool start);
+    bool startProgram(int encoderId);
+    void stopProgram(int encoderId);
+    void retargetProgram(int encoderId, const ProgramKeyframe& target); // Ease from what is shown now to target
+    bool isProgramRunning(int encoderId) const;
+    
+    // Overlays drawn over the ring's pattern (OVERLAY_NONE clears the slot)
+    bool setOverlay(int encoderId, int slot, const LEDOverlay& overlay);
+    void clearOverlays(int encoderId);
+    
+    // Level meters - one byte per ring starting at firstEncoder (255 = full)
+    void setMeterLevels(int firstEncoder, const uint8_t* levels, int count);
+    
+    // Pixel streaming - target is an encoder id, or -1 for the whole strip.
+    // Returns false if the frame was rejected (null/malformed ops or over the window).
+    bool applyStreamFrame(int target, uint32_t seq, bool keyFrame, const uint8_t* ops, size_t length);
+    bool takeStreamAck(StreamAck& ack); // True once per strip push carrying stream data
+    unsigned long getStreamFrames() const { return streamFrames; }
+    unsigned long getStreamDropped() const { return streamDropped; }
+    unsigned long getStreamSuperseded() const { return streamSuperseded; }
+    
+    // Encoder feedback fast path: renders just this ring and pushes it
+    // immediately, or as soon as the show() rate limit allows
+    void commitEncoderValue(int encoderId, float value, unsigned long eventMicros);
+    
     // System control
-    void setBrightness(uint8_t brightness);
+    void setBrightness(uint8_t newBrightness);
     void clearAll();
     void showTestPattern();
     void showErrorPattern();
     void showStartupSequence();
     void simpleColorTest(int step);  // Add this for debugging
     
-    // NEW: Diagnostic functions for troubleshooting
-    void runFullDiagnostics();
+    // Diagnostic functions for troubleshooting
+    // Long-running tests start a non-blocking task advanced by update();
+    // they return false if another diagnostic is already running.
+    bool runFullDiagnostics();
     void testLEDRange(int startLED, int endLED, CRGB color);
-    void sequentialTest(int delayMs);
-    void findLEDCount(); // Auto-detect actual strip length
-    void testSignalIntegrity(); // Test for level shifting issues
+    bool sequentialTest(int delayMs);
+    bool findLEDCount(); // Auto-detect actual strip length
+    bool testSignalIntegrity(); // Test for level shifting issues
+    void cancelDiagnostics();
+    bool isDiagnosticRunning() const { return diag.task != DIAG_NONE; }
+    const char* getDiagnosticName() const;
+    int getDiagnosticProgress() const; // Percent complete (0-100)
+    int getDiagnosticStep() const { return diag.stepsDone; }
+    int getDiagnosticTotalSteps() const { return diag.totalSteps; }
     
     // Status
     bool isInitialized() const { return initialized; }
     CRGB getEncoderColor(int encoderId) const;
     float getEncoderValue(int encoderId) const;
+    unsigned long getFramesRendered() const { return framesRendered; }
+    unsigned long getFramesSkipped() const { return framesSkipped; }
+    unsigned long getUpdatesCoalesced() const { return updatesCoalesced; }
+    const LEDFrameStats& getFrameStats() const { return frameStats; }
+    void resetFrameStats() { frameStatsReset(frameStats); }
+    unsigned long getEncoderLatencyLastUs() const { return latencyLastUs; }
+    unsigned long getEncoderLatencyMaxUs() const { return latencyMaxUs; }
+    unsigned long getEncoderLatencyAvgUs() const { return latencySamples ? latencyTotalUs / latencySamples : 0; }
+    void resetEncoderLatency();
+    unsigned long getRefreshCount() const { return refreshCount; }
+    unsigned long getRefreshTotalUs() const { return refreshTotalUs; }
+    uint8_t getBrightness() const { return brightness; }
+    uint8_t getOutputBrightness() const { return output->getBrightness(); } // After power limiting
+    int getStripCount() const { return output->getStripCount(); }
+    unsigned long getStripShowMicros(int strip) const { return output->getStripShowMicros(strip); }
 
 private:
     // Pattern implementations
@@ -67,19 +237,48 @@ private:
     void renderPulse(int encoderId);
     void renderRainbow(int encoderId);
     void renderOff(int encoderId);
+    void renderProgram(int encoderId);
+    void renderStream(int encoderId);
+    void renderMeter(int encoderId);
     
     // Utilities
     void renderEncoder(int encoderId);
-    int getEncoderStartIndex(int encoderId) const;
-    int getEncoderEndIndex(int encoderId) const;
+    void composeLayers(int encoderId);
+    void startCrossfade(int encoderId);
+    void buildRingLayout();
     bool isValidEncoderId(int encoderId) const;
-    CRGB blendColors(CRGB color1, CRGB color2, float ratio);
-    uint8_t scaleBrightness(uint8_t value, float scale);
+    bool isAnimatedPattern(LEDPattern pattern) const;
+    void markAllDirty();
+    ProgramSample sampleRing(int encoderId);
+    void freezeProgram(int encoderId, const ProgramSample& sample);
+    void clearBuffer();
+    void commitPendingRings();
+    void applyStagedUpdates();
+    void flushStagedUpdate(int encoderId);
+    void pushFrame();
+    void showFullFrame();
+    void updateRingPower(int encoderId);
+    void applyPowerLimit(uint32_t power);
+    void markStripsPushed(uint32_t stripMask);
+    void refreshStaleStrips(unsigned long currentTime);
+    
+    // Diagnostic task engine
+    bool startDiagnostic(DiagnosticTask task, int delayMs);
+    void finishDiagnostic();
+    void updateDiagnostic();
+    bool stepFullDiagnostics(unsigned long& waitMs);
+    bool stepSequentialTest(unsigned long& waitMs);
+    bool stepFindLEDCount(unsigned long& waitMs);
+    bool stepSignalIntegrity(unsigned long& waitMs);
     
     // Animation helpers
-    void updateAnimationPhases();
-    float getPulseValue(float phase);
-    CRGB getRainbowColor(float phase);
+    void updateAnimationPhases(unsigned long currentMicros);
+    void updateMeters(unsigned long elapsedUs, unsigned long currentMicros);
+    void updateValueTweens(unsigned long elapsedUs);
+    void setRingValue(EncoderRing& ring, float value, bool tween);
+    bool isTweening(const EncoderRing& ring) const;
+    unsigned long getFrameIntervalUs() const;
+    unsigned long getPatternFrameIntervalUs(LEDPattern pattern) const;
 };
 
 // Global instance (defined in .cpp file)
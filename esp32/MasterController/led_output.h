@@ -0,0 +1,49 @@
+#ifndef LED_OUTPUT_H
+#define LED_OUTPUT_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+// ============================================================================
+// LED Output Backend
+// Pushes the rendered frame to the physical strip (or anywhere else).
+// LEDController renders into its own CRGB buffer and only talks to the
+// hardware through this interface, so the render pipeline can also run on
+// the host against a capture sink (see bench/host/capture_output.h).
+//
+// The frame buffer may be split across several independent strip outputs
+// (STRIP_LAYOUT in ring_layout.h); bit n of a strip mask selects strip n.
+// ============================================================================
+
+#define LED_ALL_STRIPS 0xFFFFFFFFUL
+
+class LEDOutput {
+public:
+    virtual ~LEDOutput() {}
+    
+    // Bind the frame buffer owned by LEDController
+    virtual void begin(CRGB* leds, int count) = 0;
+    
+    // Push the strips in stripMask from the current frame buffer. Backends
+    // may push more than requested (e.g. when global brightness changes).
+    // Returns false if the output was busy and did not take the frame - the
+    // caller keeps it and tries again later.
+    virtual bool show(uint32_t stripMask = LED_ALL_STRIPS) = 0;
+    
+    // True while a previous frame is still being transferred; show() would
+    // refuse a new one until it finishes
+    virtual bool isBusy() const { return false; }
+    
+    // Global brightness applied on output (0-255)
+    virtual void setBrightness(uint8_t brightness) = 0;
+    virtual uint8_t getBrightness() const = 0;
+    
+    // Strip outputs and the duration of each one's last transfer
+    virtual int getStripCount() const { return 1; }
+    virtual unsigned long getStripShowMicros(int /*strip*/) const { return 0; }
+    
+    // Human-readable backend name for logs/diagnostics
+    virtual const char* getName() const = 0;
+};
+
+#endif // LED_OUTPUT_H
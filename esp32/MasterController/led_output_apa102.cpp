@@ -0,0 +1,105 @@
+#include "led_output_apa102.h"
+#include "logger.h"
+
+// The backend is only built when selected, so its wire buffer and SPI
+// hosts cost nothing otherwise
+#if LED_OUTPUT_HDR
+
+#if LED_STRIP_COUNT > 2
+#error "APA102 HDR output has one SPI host per strip - use at most 2 strips or disable LED_OUTPUT_HDR"
+#endif
+
+// Global instance
+APA102HDROutput apa102HDROutput;
+
+// One SPI host per strip
+static SPIClass fspiBus(FSPI);
+static SPIClass hspiBus(HSPI);
+static SPIClass* const STRIP_BUSES[] = {&fspiBus, &hspiBus};
+
+// Wire position of each channel, following COLOR_ORDER like FastLED does
+static const uint8_t WIRE_CHANNEL[3] = {
+    RGB_BYTE0(COLOR_ORDER), RGB_BYTE1(COLOR_ORDER), RGB_BYTE2(COLOR_ORDER)
+};
+
+APA102HDROutput::APA102HDROutput()
+    : frame(nullptr), brightness(LED_BRIGHTNESS), lastShownBrightness(0) {
+    for (int i = 0; i < LED_STRIP_COUNT; i++) {
+        buses[i] = nullptr;
+        stripShowMicros[i] = 0;
+    }
+}
+
+void APA102HDROutput::begin(CRGB* leds, int count) {
+    frame = leds;
+    
+    static const int8_t dataPins[] = {LED_DATA_PIN, LED_STRIP1_DATA_PIN};
+    static const int8_t clockPins[] = {LED_CLOCK_PIN, LED_STRIP1_CLOCK_PIN};
+    
+    for (int i = 0; i < LED_STRIP_COUNT; i++) {
+        buses[i] = STRIP_BUSES[i];
+        buses[i]->begin(clockPins[i], -1, dataPins[i], -1);
+        LOG_INFO("LED", "Strip %d: LEDs %d-%d", i,
+                 STRIP_LAYOUT[i].start, STRIP_LAYOUT[i].start + STRIP_LAYOUT[i].count - 1);
+    }
+    
+    hdrTableBuild(table, LED_COLOR_CORRECTION, LED_COLOR_TEMPERATURE);
+    lastShownBrightness = brightness;
+    
+    LOG_INFO("LED", "APA102 HDR output ready - SPI %lu Hz, Pins: DATA=%d CLOCK=%d, LEDs: %d",
+             (unsigned long)LED_HDR_SPI_HZ, LED_DATA_PIN, LED_CLOCK_PIN, count);
+}
+
+int APA102HDROutput::encodeStrip(int strip) {
+    const CRGB* pixels = frame + STRIP_LAYOUT[strip].start;
+    int count = STRIP_LAYOUT[strip].count;
+    uint8_t* out = wire;
+    
+    // Start frame
+    *out++ = 0; *out++ = 0; *out++ = 0; *out++ = 0;
+    
+    for (int i = 0; i < count; i++) {
+        HDRPixel pixel = hdrEncode(table, brightness, pixels[i].r, pixels[i].g, pixels[i].b);
+        uint8_t channels[3] = {pixel.r, pixel.g, pixel.b};
+        *out++ = 0xE0 | pixel.gb;
+        *out++ = channels[WIRE_CHANNEL[0]];
+        *out++ = channels[WIRE_CHANNEL[1]];
+        *out++ = channels[WIRE_CHANNEL[2]];
+    }
+    
+    // End frame - data is delayed half a clock per LED, so keep clocking
+    int endBytes = 4 + count / 16;
+    memset(out, 0xFF, endBytes);
+    out += endBytes;
+    
+    return out - wire;
+}
+
+bool APA102HDROutput::show(uint32_t stripMask) {
+    if (!frame) return true;
+    
+    // A brightness change affects every strip
+    if (brightness != lastShownBrightness) {
+        stripMask = LED_ALL_STRIPS;
+        lastShownBrightness = brightness;
+    }
+    
+    for (int i = 0; i < LED_STRIP_COUNT; i++) {
+        if (!(stripMask & (1UL << i))) continue;
+        
+        unsigned long start = micros();
+        int length = encodeStrip(i);
+        buses[i]->beginTransaction(SPISettings(LED_HDR_SPI_HZ, MSBFIRST, SPI_MODE0));
+        buses[i]->writeBytes(wire, length);
+        buses[i]->endTransaction();
+        stripShowMicros[i] = micros() - start;
+    }
+    return true;
+}
+
+unsigned long APA102HDROutput::getStripShowMicros(int strip) const {
+    if (strip < 0 || strip >= LED_STRIP_COUNT) return 0;
+    return stripShowMicros[strip];
+}
+
+#endif // LED_OUTPUT_HDR
@@ -0,0 +1,55 @@
+#ifndef LED_OUTPUT_APA102_H
+#define LED_OUTPUT_APA102_H
+
+#include "led_output.h"
+#include "led_scaling.h"
+#include "config.h"
+#include "ring_layout.h"
+#include <SPI.h>
+
+// ============================================================================
+// APA102 HDR Output Backend
+// Drives the APA102 strips over hardware SPI without FastLED's scaling.
+// Brightness and color correction go through an HDRTable (led_scaling.h):
+// each pixel's intensity is split between the 5-bit per-pixel global
+// brightness field and the 8-bit channels, so dim frames keep full color
+// resolution. The table is built once at begin(); brightness is a per-pixel
+// multiply, so power limiting can move it every frame for free.
+//
+// One SPI host per strip, so at most two strips (FSPI + HSPI).
+// ============================================================================
+
+// Largest wire frame for any strip: start frame, 4 bytes per LED, end frame
+#define APA102_WIRE_BYTES(count) (4 + (count) * 4 + 4 + (count) / 16)
+
+class APA102HDROutput : public LEDOutput {
+public:
+    APA102HDROutput();
+    
+    void begin(CRGB* leds, int count) override;
+    bool show(uint32_t stripMask = LED_ALL_STRIPS) override;
+    void setBrightness(uint8_t value) override { brightness = value; }
+    uint8_t getBrightness() const override { return brightness; }
+    int getStripCount() const override { return LED_STRIP_COUNT; }
+    unsigned long getStripShowMicros(int strip) const override;
+    const char* getName() const override { return "apa102_hdr"; }
+
+private:
+    int encodeStrip(int strip);
+    
+    CRGB* frame;
+    SPIClass* buses[LED_STRIP_COUNT];
+    unsigned long stripShowMicros[LED_STRIP_COUNT];
+    uint8_t brightness;
+    uint8_t lastShownBrightness;
+    
+    HDRTable table;
+    uint8_t wire[APA102_WIRE_BYTES(TOTAL_LEDS)];
+};
+
+// Global instance (defined in .cpp file when LED_OUTPUT_HDR is enabled)
+#if LED_OUTPUT_HDR
+extern APA102HDROutput apa102HDROutput;
+#endif
+
+#endif // LED_OUTPUT_APA102_H
@@ -0,0 +1,80 @@
+#include "led_output_fastled.h"
+#include "led_scaling.h"
+#include "logger.h"
+
+#if LED_STRIP_COUNT > LED_MAX_STRIPS
+#error "LED_STRIP_COUNT exceeds the strip pins defined in config.h"
+#endif
+
+// Global instance
+FastLEDOutput fastLEDOutput;
+
+void FastLEDOutput::begin(CRGB* leds, int count) {
+    // Initialize FastLED for DotStar/APA102 - pins are template parameters,
+    // so each strip output is registered explicitly
+    controllers[0] = &FastLED.addLeds<LED_TYPE, LED_DATA_PIN, LED_CLOCK_PIN, COLOR_ORDER>(
+        leds + STRIP_LAYOUT[0].start, STRIP_LAYOUT[0].count);
+#if LED_STRIP_COUNT > 1
+    controllers[1] = &FastLED.addLeds<LED_TYPE, LED_STRIP1_DATA_PIN, LED_STRIP1_CLOCK_PIN, COLOR_ORDER>(
+        leds + STRIP_LAYOUT[1].start, STRIP_LAYOUT[1].count);
+#endif
+#if LED_STRIP_COUNT > 2
+    controllers[2] = &FastLED.addLeds<LED_TYPE, LED_STRIP2_DATA_PIN, LED_STRIP2_CLOCK_PIN, COLOR_ORDER>(
+        leds + STRIP_LAYOUT[2].start, STRIP_LAYOUT[2].count);
+#endif
+    
+    // Correction x temperature computed once, so each show() only scales
+    // by brightness (warmer color temperature)
+    CRGB adjustment(colorChannelScale(LED_COLOR_CORRECTION, LED_COLOR_TEMPERATURE, 0, 255),
+                    colorChannelScale(LED_COLOR_CORRECTION, LED_COLOR_TEMPERATURE, 1, 255),
+                    colorChannelScale(LED_COLOR_CORRECTION, LED_COLOR_TEMPERATURE, 2, 255));
+    for (int i = 0; i < LED_STRIP_COUNT; i++) {
+        controllers[i]->setCorrection(adjustment);
+        stripShowMicros[i] = 0;
+    }
+    
+    FastLED.setTemperature(UncorrectedTemperature);
+    lastShownBrightness = 0;
+    
+    LOG_INFO("LED", "FastLED initialized - DotStar/APA102 strips ready");
+    for (int i = 0; i < LED_STRIP_COUNT; i++) {
+        LOG_INFO("LED", "Strip %d: LEDs %d-%d", i,
+                 STRIP_LAYOUT[i].start, STRIP_LAYOUT[i].start + STRIP_LAYOUT[i].count - 1);
+    }
+    LOG_INFO("LED", "Type: %s, Pins: DATA=%d CLOCK=%d, LEDs: %d",
+             "APA102", LED_DATA_PIN, LED_CLOCK_PIN, count);
+}
+
+bool FastLEDOutput::show(uint32_t stripMask) {
+    // Already power limited by LEDController
+    uint8_t brightness = FastLED.getBrightness();
+    
+    // A brightness change affects every strip
+    if (brightness != lastShownBrightness) {
+        stripMask = LED_ALL_STRIPS;
+        lastShownBrightness = brightness;
+    }
+    
+    // Push strips back to back from the same frame buffer - no re-render
+    for (int i = 0; i < LED_STRIP_COUNT; i++) {
+        if (!(stripMask & (1UL << i))) continue;
+        
+        unsigned long start = micros();
+        controllers[i]->showLeds(brightness);
+        stripShowMicros[i] = micros() - start;
+    }
+    return true;
+}
+
+void FastLEDOutput::setBrightness(uint8_t brightness) {
+    FastLED.setBrightness(brightness);
+}
+
+uint8_t FastLEDOutput::getBrightness() const {
+    return FastLED.getBrightness();
+}
+
+unsigned long FastLEDOutput::getStripShowMicros(int strip) const {
+    if (strip < 0 || strip >= LED_STRIP_COUNT) return 0;
+    return stripShowMicros[strip];
+}
@@ -0,0 +1,37 @@
+#ifndef LED_OUTPUT_FASTLED_H
+#define LED_OUTPUT_FASTLED_H
+
+#include "led_output.h"
+#include "config.h"
+#include "ring_layout.h"
+
+// ============================================================================
+// FastLED Output Backend
+// Drives up to LED_MAX_STRIPS APA102 strips through FastLED, one controller
+// per strip slice of the frame buffer. Strips are pushed back to back and
+// only when their pixels (or the global brightness) changed.
+//
+// Power limiting is done by LEDController before show(); color correction
+// and temperature are folded into one per-channel adjustment at begin().
+// ============================================================================
+
+class FastLEDOutput : public LEDOutput {
+public:
+    void begin(CRGB* leds, int count) override;
+    bool show(uint32_t stripMask = LED_ALL_STRIPS) override;
+    void setBrightness(uint8_t brightness) override;
+    uint8_t getBrightness() const override;
+    int getStripCount() const override { return LED_STRIP_COUNT; }
+    unsigned long getStripShowMicros(int strip) const override;
+    const char* getName() const override { return "fastled"; }
+
+private:
+    CLEDController* controllers[LED_STRIP_COUNT];
+    unsigned long stripShowMicros[LED_STRIP_COUNT];
+    uint8_t lastShownBrightness;
+};
+
+// Global instance (defined in .cpp file)
+extern FastLEDOutput fastLEDOutput;
+
+#endif // LED_OUTPUT_FASTLED_H
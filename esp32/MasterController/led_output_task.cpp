@@ -0,0 +1,71 @@
+#include "led_output_task.h"
+#include "led_output_fastled.h"
+#include "led_output_apa102.h"
+#include "logger.h"
+
+// Global instance wrapping the strip backend selected in config.h - only
+// built when the task is enabled, so its front buffer costs no RAM otherwise
+#if LED_OUTPUT_TASK
+#if LED_OUTPUT_HDR
+TaskedLEDOutput ledOutputTask(apa102HDROutput);
+#else
+TaskedLEDOutput ledOutputTask(fastLEDOutput);
+#endif
+#endif
+
+TaskedLEDOutput::TaskedLEDOutput(LEDOutput& target)
+    : inner(target), backBuffer(nullptr), ledCount(0), task(nullptr), idleSemaphore(nullptr),
+      taskStripMask(0), taskBrightness(0), brightness(0), framesHandedOff(0), refusedHandoffs(0) {
+}
+
+void TaskedLEDOutput::begin(CRGB* leds, int count) {
+    backBuffer = leds;
+    ledCount = min(count, TOTAL_LEDS);
+    
+    // The strip driver only ever sees the front buffer
+    memcpy(frontBuffer, backBuffer, ledCount * sizeof(CRGB));
+    inner.begin(frontBuffer, ledCount);
+    brightness = inner.getBrightness();
+    
+    idleSemaphore = xSemaphoreCreateBinary();
+    xSemaphoreGive(idleSemaphore);
+    
+    xTaskCreatePinnedToCore(taskEntry, "led_output", LED_OUTPUT_TASK_STACK, this,
+                            LED_OUTPUT_TASK_PRIORITY, &task, LED_OUTPUT_TASK_CORE);
+    
+    LOG_INFO("LED", "Output task started on core %d (loop on core %d)",
+             LED_OUTPUT_TASK_CORE, xPortGetCoreID());
+}
+
+bool TaskedLEDOutput::show(uint32_t stripMask) {
+    // Never wait for the task - a busy output refuses the frame and the
+    // caller hands it off again once isBusy() clears
+    if (xSemaphoreTake(idleSemaphore, 0) != pdTRUE) {
+        refusedHandoffs++;
+        return false;
+    }
+    
+    memcpy(frontBuffer, backBuffer, ledCount * sizeof(CRGB));
+    taskStripMask = stripMask;
+    taskBrightness = brightness;
+    framesHandedOff++;
+    xTaskNotifyGive(task);
+    return true;
+}
+
+bool TaskedLEDOutput::isBusy() const {
+    return uxSemaphoreGetCount(idleSemaphore) == 0;
+}
+
+void TaskedLEDOutput::taskEntry(void* param) {
+    static_cast<TaskedLEDOutput*>(param)->runTask();
+}
+
+void TaskedLEDOutput::runTask() {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        inner.setBrightness(taskBrightness);
+        inner.show(taskStripMask);
+        xSemaphoreGive(idleSemaphore);
+    }
+}
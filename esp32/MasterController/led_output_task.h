@@ -0,0 +1,69 @@
+#ifndef LED_OUTPUT_TASK_H
+#define LED_OUTPUT_TASK_H
+
+#include "led_output.h"
+#include "config.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+// ============================================================================
+// Tasked LED Output
+// Double-buffered wrapper around another output backend. LEDController keeps
+// rendering into its own (back) buffer; show() copies the finished frame into
+// a front buffer owned by a FreeRTOS task pinned to LED_OUTPUT_TASK_CORE,
+// which performs the strip transfer. The copy only happens while the task is
+// idle, so a frame is never modified mid-transfer.
+//
+// The back buffer is copied rather than swapped because LEDController only
+// re-renders rings that changed - the back buffer must always hold the full
+// current frame.
+// ============================================================================
+
+class TaskedLEDOutput : public LEDOutput {
+public:
+    TaskedLEDOutput(LEDOutput& target);
+    
+    void begin(CRGB* leds, int count) override;
+    
+    // Hand the frame to the output task. Refuses it (returns false) while
+    // the previous transfer is still in flight.
+    bool show(uint32_t stripMask = LED_ALL_STRIPS) override;
+    bool isBusy() const override;
+    
+    // Brightness travels with the frame it was set for
+    void setBrightness(uint8_t value) override { brightness = value; }
+    uint8_t getBrightness() const override { return brightness; }
+    int getStripCount() const override { return inner.getStripCount(); }
+    unsigned long getStripShowMicros(int strip) const override { return inner.getStripShowMicros(strip); }
+    const char* getName() const override { return "tasked"; }
+    
+    // Statistics
+    unsigned long getFramesHandedOff() const { return framesHandedOff; }
+    unsigned long getRefusedHandoffs() const { return refusedHandoffs; }
+
+private:
+    LEDOutput& inner;
+    CRGB frontBuffer[TOTAL_LEDS];
+    CRGB* backBuffer;
+    int ledCount;
+    
+    TaskHandle_t task;
+    SemaphoreHandle_t idleSemaphore;   // Given by the task when it is ready for a frame
+    volatile uint32_t taskStripMask;
+    volatile uint8_t taskBrightness;
+    uint8_t brightness;
+    
+    unsigned long framesHandedOff;
+    unsigned long refusedHandoffs;
+    
+    static void taskEntry(void* param);
+    void runTask();
+};
+
+// Global instance (defined in .cpp file when LED_OUTPUT_TASK is enabled)
+#if LED_OUTPUT_TASK
+extern TaskedLEDOutput ledOutputTask;
+#endif
+
+#endif // LED_OUTPUT_TASK_H
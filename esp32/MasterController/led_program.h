@@ -0,0 +1,138 @@
+#ifndef LED_PROGRAM_H
+#define LED_PROGRAM_H
+
+#include <stdint.h>
+#include "config.h"
+
+// ============================================================================
+// LED Keyframe Programs
+// Small per-ring animations uploaded once over UART and played back locally
+// by LEDController. A program is a list of keyframes (color + fill level);
+// each keyframe eases into the next over its duration. Evaluation is integer
+// only and free of Arduino/FastLED dependencies.
+//
+// Loop modes:
+//   once     - play kf[0] -> kf[n-1], then hold the last keyframe
+//   repeat   - play kf[0] -> kf[n-1] -> kf[0] forever (last duration wraps)
+//   pingpong - play kf[0] -> kf[n-1] -> kf[0] back along the same path
+// ============================================================================
+
+enum ProgramEasing {
+    EASE_LINEAR,
+    EASE_IN,
+    EASE_OUT,
+    EASE_IN_OUT,
+    EASE_STEP       // Hold, then jump at the end of the segment
+};
+
+enum ProgramLoop {
+    PROGRAM_ONCE,
+    PROGRAM_REPEAT,
+    PROGRAM_PINGPONG
+};
+
+struct ProgramKeyframe {
+    uint8_t r, g, b;
+    uint8_t level;          // Ring fill level (255 = whole ring)
+    uint8_t easing;         // ProgramEasing into the next keyframe
+    uint16_t durationMs;    // Time taken to reach the next keyframe
+};
+
+struct LEDProgram {
+    ProgramKeyframe keyframes[LED_PROGRAM_MAX_KEYFRAMES];
+    uint8_t count;
+    uint8_t loop;           // ProgramLoop
+};
+
+struct ProgramSample {
+    uint8_t r, g, b;
+    uint8_t level;
+    bool finished;          // A 'once' program has reached its last keyframe
+};
+
+// Apply easing to a segment position (0..65536)
+inline uint32_t programEase(uint32_t t, uint8_t easing) {
+    switch (easing) {
+        case EASE_IN:
+            return (uint32_t)(((uint64_t)t * t) >> 16);
+        case EASE_OUT: {
+            uint32_t inv = 65536 - t;
+            return 65536 - (uint32_t)(((uint64_t)inv * inv) >> 16);
+        }
+        case EASE_IN_OUT:
+            // Smoothstep: t^2 * (3 - 2t)
+            return (uint32_t)(((uint64_t)t * t * (3 * 65536 - 2 * t)) >> 32);
+        case EASE_STEP:
+            return t >= 65536 ? 65536 : 0;
+        default:
+            return t;
+    }
+}
+
+inline uint8_t programLerp8(uint8_t a, uint8_t b, uint32_t t) {
+    return (uint8_t)(((uint32_t)a * (65536 - t) + (uint32_t)b * t) >> 16);
+}
+
+// Length of one full pass through the program in milliseconds
+inline uint32_t programCycleMs(const LEDProgram& program) {
+    if (program.count < 2) return 0;
+
+    uint32_t forward = 0;
+    for (int i = 0; i < program.count - 1; i++) {
+        forward += program.keyframes[i].durationMs;
+    }
+
+    switch (program.loop) {
+        case PROGRAM_REPEAT:
+            return forward + program.keyframes[program.count - 1].durationMs;
+        case PROGRAM_PINGPONG:
+            return forward * 2;
+        default:
+            return forward;
+    }
+}
+
+// Sample the program at elapsedMs since it was started
+inline ProgramSample programEvaluate(const LEDProgram& program, uint32_t elapsedMs) {
+    ProgramSample sample = {0, 0, 0, 0, true};
+    if (program.count == 0) return sample;
+
+    const ProgramKeyframe& last = program.keyframes[program.count - 1];
+    uint32_t cycle = programCycleMs(program);
+    if (cycle == 0 || (program.loop == PROGRAM_ONCE && elapsedMs >= cycle)) {
+        sample.r = last.r;
+        sample.g = last.g;
+        sample.b = last.b;
+        sample.level = last.level;
+        sample.finished = (program.loop == PROGRAM_ONCE || program.count < 2);
+        return sample;
+    }
+
+    uint32_t t = elapsedMs % cycle;
+    if (program.loop == PROGRAM_PINGPONG && t >= cycle / 2) {
+        t = cycle - t;  // Walk the forward path backwards
+    }
+
+    // Find the segment containing t
+    int segments = (program.loop == PROGRAM_REPEAT) ? program.count : program.count - 1;
+    int i = 0;
+    while (i < segments - 1 && t >= program.keyframes[i].durationMs) {
+        t -= program.keyframes[i].durationMs;
+        i++;
+    }
+
+    const ProgramKeyframe& from = program.keyframes[i];
+    const ProgramKeyframe& to = program.keyframes[(i + 1) % program.count];
+    if (t > from.durationMs) t = from.durationMs;
+    uint32_t position = from.durationMs ? (uint32_t)(((uint64_t)t << 16) / from.durationMs) : 65536;
+    uint32_t eased = programEase(position, from.easing);
+
+    sample.r = programLerp8(from.r, to.r, eased);
+    sample.g = programLerp8(from.g, to.g, eased);
+    sample.b = programLerp8(from.b, to.b, eased);
+    sample.level = programLerp8(from.level, to.level, eased);
+    sample.finished = false;
+    return sample;
+}
+
+#endif // LED_PROGRAM_H
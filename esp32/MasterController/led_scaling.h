@@ -0,0 +1,142 @@
+#ifndef LED_SCALING_H
+#define LED_SCALING_H
+
+#include <stdint.h>
+
+// ============================================================================
+// LED Output Scaling
+// Power estimation and color correction shared by LEDController and the
+// output backends. Header-only and free of Arduino/FastLED dependencies.
+//
+// Power follows FastLED's model (power_mgt.cpp) so the limit matches what
+// FastLED.setMaxPowerInVoltsAndMilliamps() would do, but LEDController keeps
+// the per-ring sums incrementally instead of walking the strip every show().
+// Power sums are in mW * 256 at full brightness, ignoring dark LED draw.
+// ============================================================================
+
+static const uint32_t LED_POWER_RED_MW = 16 * 5;
+static const uint32_t LED_POWER_GREEN_MW = 11 * 5;
+static const uint32_t LED_POWER_BLUE_MW = 15 * 5;
+static const uint32_t LED_POWER_DARK_MW = 1 * 5;
+static const uint32_t LED_POWER_MCU_MW = 25 * 5;
+
+// Unscaled power of count pixels reached through indexMap
+template <typename Pixel>
+inline uint32_t powerSumMapped(const Pixel* strip, const uint16_t* indexMap, int count) {
+    uint32_t red = 0, green = 0, blue = 0;
+    for (int i = 0; i < count; i++) {
+        const Pixel& pixel = strip[indexMap[i]];
+        red += pixel.r;
+        green += pixel.g;
+        blue += pixel.b;
+    }
+    return red * LED_POWER_RED_MW + green * LED_POWER_GREEN_MW + blue * LED_POWER_BLUE_MW;
+}
+
+// Unscaled power of a contiguous pixel span
+template <typename Pixel>
+inline uint32_t powerSum(const Pixel* pixels, int count) {
+    uint32_t red = 0, green = 0, blue = 0;
+    for (int i = 0; i < count; i++) {
+        red += pixels[i].r;
+        green += pixels[i].g;
+        blue += pixels[i].b;
+    }
+    return red * LED_POWER_RED_MW + green * LED_POWER_GREEN_MW + blue * LED_POWER_BLUE_MW;
+}
+
+// Highest brightness <= target that keeps the frame within budgetMw
+inline uint8_t powerLimitBrightness(uint32_t powerSum, int ledCount, uint8_t target, uint32_t budgetMw) {
+    uint32_t totalMw = LED_POWER_MCU_MW + (powerSum >> 8) + LED_POWER_DARK_MW * ledCount;
+    uint32_t requested = (totalMw * target) / 256;
+
+    if (requested <= budgetMw) return target;
+    return (uint8_t)(((uint32_t)target * budgetMw) / requested);
+}
+
+// Per-channel output scale for correction x temperature x brightness, the
+// same combination FastLED applies in showLeds(). Channel 0 = red.
+inline uint8_t colorChannelScale(uint32_t correction, uint32_t temperature, int channel, uint8_t brightness) {
+    uint32_t c = (correction >> (16 - 8 * channel)) & 0xFF;
+    uint32_t t = (temperature >> (16 - 8 * channel)) & 0xFF;
+    if (c == 0 || t == 0 || brightness == 0) return 0;
+
+    uint32_t work = (c + 1) * (t + 1) * brightness;
+    return (uint8_t)((work / 0x10000) & 0xFF);
+}
+
+// ============================================================================
+// APA102 HDR Scaling
+// APA102 pixels carry a 5-bit global brightness (gb) in front of the 8-bit
+// channels. Instead of scaling the channels down (an 8-bit value at
+// brightness 12 keeps only ~4 bits), each pixel's intensity is kept at 16-bit
+// precision and split between gb and the channels: gb is the smallest level
+// that still fits the brightest channel, the channels take up the rest.
+//
+// Correction and temperature are tabulated once at full brightness; global
+// brightness is applied per pixel as one multiply per channel, so a
+// brightness change (power limiting moves it per frame) costs no rebuild.
+// ============================================================================
+
+#define HDR_GB_MAX 31
+
+struct HDRTable {
+    uint16_t intensity[3][256];     // value -> corrected intensity at full brightness (65535 = full)
+    uint8_t gbForIntensity[256];    // (max channel intensity >> 8) -> gb
+    uint32_t channelScale[HDR_GB_MAX + 1]; // gb -> intensity to 8-bit channel (16.16)
+};
+
+struct HDRPixel {
+    uint8_t gb;                     // 0..31
+    uint8_t r, g, b;
+};
+
+inline void hdrTableBuild(HDRTable& table, uint32_t correction, uint32_t temperature) {
+    for (int c = 0; c < 3; c++) {
+        // Same factors as colorChannelScale(), without truncating to 8 bits;
+        // brightness 256 here, hdrEncode() scales by brightness / 256
+        uint32_t cc = (correction >> (16 - 8 * c)) & 0xFF;
+        uint32_t t = (temperature >> (16 - 8 * c)) & 0xFF;
+        uint64_t work = (cc && t) ? (uint64_t)(cc + 1) * (t + 1) * 256 : 0;
+        for (int v = 0; v < 256; v++) {
+            // v/255 * work/2^24 at 16 bits
+            table.intensity[c][v] = (uint16_t)((v * work * 65535) / (255ULL << 24));
+        }
+    }
+
+    // Round gb up for the top of each 256-wide bucket so channels never overflow
+    for (int i = 0; i < 256; i++) {
+        uint32_t top = (uint32_t)i * 256 + 255;
+        table.gbForIntensity[i] = (uint8_t)((top * HDR_GB_MAX + 65534) / 65535);
+    }
+
+    // channel = intensity / 65535 * 255 * 31 / gb, rounded
+    table.channelScale[0] = 0;
+    for (int gb = 1; gb <= HDR_GB_MAX; gb++) {
+        table.channelScale[gb] = (uint32_t)(((uint64_t)255 * HDR_GB_MAX << 16) / (65535ULL * gb));
+    }
+}
+
+inline uint8_t hdrChannel(uint32_t intensity, uint32_t scale) {
+    uint32_t value = (intensity * scale + 0x8000) >> 16;
+    return value > 255 ? 255 : (uint8_t)value;
+}
+
+inline HDRPixel hdrEncode(const HDRTable& table, uint8_t brightness, uint8_t r, uint8_t g, uint8_t b) {
+    uint32_t ir = (table.intensity[0][r] * (uint32_t)brightness) >> 8;
+    uint32_t ig = (table.intensity[1][g] * (uint32_t)brightness) >> 8;
+    uint32_t ib = (table.intensity[2][b] * (uint32_t)brightness) >> 8;
+
+    uint32_t peak = ir > ig ? ir : ig;
+    if (ib > peak) peak = ib;
+
+    HDRPixel pixel;
+    pixel.gb = table.gbForIntensity[peak >> 8];
+    uint32_t scale = table.channelScale[pixel.gb];
+    pixel.r = hdrChannel(ir, scale);
+    pixel.g = hdrChannel(ig, scale);
+    pixel.b = hdrChannel(ib, scale);
+    return pixel;
+}
+
+#endif // LED_SCALING_H
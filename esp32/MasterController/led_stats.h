@@ -0,0 +1,68 @@
+#ifndef LED_STATS_H
+#define LED_STATS_H
+
+#include <stdint.h>
+
+// ============================================================================
+// LED Frame Timing Statistics
+// Fixed-bucket histograms of render time, show time, frame interval and
+// deadline lateness, kept by LEDController and reported in status and by the
+// led_stats system command. Recording is a short linear scan - no division,
+// no allocation. Header-only and free of Arduino/FastLED dependencies.
+// ============================================================================
+
+#define LED_STATS_BUCKETS 11
+
+// Upper bound (exclusive) of each bucket in us; the last bucket is open-ended
+static const uint32_t LED_STATS_BUCKET_US[LED_STATS_BUCKETS - 1] = {
+    50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000
+};
+
+struct TimingHistogram {
+    uint32_t counts[LED_STATS_BUCKETS];
+    uint32_t samples;
+    uint32_t maxUs;
+    uint64_t totalUs;
+};
+
+struct LEDFrameStats {
+    TimingHistogram render;      // Ring rendering + compositing per pushed frame
+    TimingHistogram show;        // output->show() per pushed frame
+    TimingHistogram interval;    // Time between pushed frames
+    TimingHistogram late;        // How far past its deadline each missed frame tick ran
+    uint32_t missed;             // Frame ticks later than LED_STATS_LATE_US
+};
+
+inline void histogramReset(TimingHistogram& histogram) {
+    for (int i = 0; i < LED_STATS_BUCKETS; i++) {
+        histogram.counts[i] = 0;
+    }
+    histogram.samples = 0;
+    histogram.maxUs = 0;
+    histogram.totalUs = 0;
+}
+
+inline void histogramRecord(TimingHistogram& histogram, uint32_t us) {
+    int bucket = 0;
+    while (bucket < LED_STATS_BUCKETS - 1 && us >= LED_STATS_BUCKET_US[bucket]) {
+        bucket++;
+    }
+    histogram.counts[bucket]++;
+    histogram.samples++;
+    histogram.totalUs += us;
+    if (us > histogram.maxUs) histogram.maxUs = us;
+}
+
+inline uint32_t histogramAverage(const TimingHistogram& histogram) {
+    return histogram.samples ? (uint32_t)(histogram.totalUs / histogram.samples) : 0;
+}
+
+inline void frameStatsReset(LEDFrameStats& stats) {
+    histogramReset(stats.render);
+    histogramReset(stats.show);
+    histogramReset(stats.interval);
+    histogramReset(stats.late);
+    stats.missed = 0;
+}
+
+#endif // LED_STATS_H
@@ -0,0 +1,118 @@
+#ifndef LED_STREAM_H
+#define LED_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// LED Pixel Stream Encoding
+// Pixel frames computed on the Pi are sent as a list of ops applied to the
+// previous frame, so unchanged pixels cost one byte per 64 and solid spans
+// cost four bytes. Header-only and free of Arduino/FastLED dependencies.
+//
+// Each op starts with one byte: the top two bits select the op, the low six
+// bits hold the pixel count minus one (1..64 pixels).
+//   00 SKIP    - leave the next n pixels as they were
+//   01 RUN     - next n pixels = one color, followed by R G B
+//   10 LITERAL - next n pixels, followed by n x R G B
+//   11           reserved (rejected)
+// Pixels past the last op are left unchanged.
+//
+// Pixel is any type with uint8_t r, g, b members (CRGB on the device).
+// ============================================================================
+
+#define STREAM_OP_SKIP 0x00
+#define STREAM_OP_RUN 0x40
+#define STREAM_OP_LITERAL 0x80
+#define STREAM_OP_MASK 0xC0
+#define STREAM_OP_MAX_COUNT 64
+
+// Decode standard base64 (padding optional). Returns the decoded length, or
+// -1 on an invalid character or if the output does not fit.
+inline int streamBase64Decode(const char* in, size_t inLength, uint8_t* out, size_t outMax) {
+    uint32_t bits = 0;
+    int bitCount = 0;
+    size_t outLength = 0;
+
+    for (size_t i = 0; i < inLength; i++) {
+        char c = in[i];
+        uint32_t v;
+        if (c >= 'A' && c <= 'Z') v = c - 'A';
+        else if (c >= 'a' && c <= 'z') v = c - 'a' + 26;
+        else if (c >= '0' && c <= '9') v = c - '0' + 52;
+        else if (c == '+') v = 62;
+        else if (c == '/') v = 63;
+        else if (c == '=') break;
+        else return -1;
+
+        bits = (bits << 6) | v;
+        bitCount += 6;
+        if (bitCount >= 8) {
+            bitCount -= 8;
+            if (outLength >= outMax) return -1;
+            out[outLength++] = (uint8_t)(bits >> bitCount);
+        }
+    }
+
+    return (int)outLength;
+}
+
+// Check that an op list is well formed and stays within count pixels
+inline bool streamValidate(const uint8_t* ops, size_t length, int count) {
+    size_t pos = 0;
+    int pixel = 0;
+
+    while (pos < length) {
+        uint8_t op = ops[pos] & STREAM_OP_MASK;
+        int n = (ops[pos] & ~STREAM_OP_MASK) + 1;
+        pos++;
+
+        if (op == STREAM_OP_RUN) {
+            pos += 3;
+        } else if (op == STREAM_OP_LITERAL) {
+            pos += 3 * n;
+        } else if (op != STREAM_OP_SKIP) {
+            return false;
+        }
+
+        pixel += n;
+        if (pos > length || pixel > count) return false;
+    }
+
+    return true;
+}
+
+// Apply a validated op list. Pixel i goes to frame[indexMap[i]], or to
+// frame[i] when indexMap is null.
+template <typename Pixel>
+inline void streamApply(Pixel* frame, const uint16_t* indexMap, const uint8_t* ops, size_t length) {
+    size_t pos = 0;
+    int pixel = 0;
+
+    while (pos < length) {
+        uint8_t op = ops[pos] & STREAM_OP_MASK;
+        int n = (ops[pos] & ~STREAM_OP_MASK) + 1;
+        pos++;
+
+        if (op == STREAM_OP_RUN) {
+            for (int i = 0; i < n; i++, pixel++) {
+                Pixel& out = frame[indexMap ? indexMap[pixel] : pixel];
+                out.r = ops[pos];
+                out.g = ops[pos + 1];
+                out.b = ops[pos + 2];
+            }
+            pos += 3;
+        } else if (op == STREAM_OP_LITERAL) {
+            for (int i = 0; i < n; i++, pixel++, pos += 3) {
+                Pixel& out = frame[indexMap ? indexMap[pixel] : pixel];
+                out.r = ops[pos];
+                out.g = ops[pos + 1];
+                out.b = ops[pos + 2];
+            }
+        } else {
+            pixel += n;
+        }
+    }
+}
+
+#endif // LED_STREAM_H
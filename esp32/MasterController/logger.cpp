@@ -0,0 +1,64 @@
+#include "logger.h"
+#include <stdarg.h>
+#include <ctype.h>
+
+// Global instance
+Logger logger;
+
+#if LOG_OUTPUT == LOG_OUTPUT_UART
+static bool writeToLogUART(uint8_t level, const char* tag, const char* text, size_t length) {
+    Serial1.printf("%c [%s] %.*s\n", toupper(Logger::levelName(level)[0]), tag, (int)length, text);
+    return true;
+}
+#endif
+
+Logger::Logger() : sink(nullptr), level(LOG_LEVEL_DEFAULT), linesWritten(0) {
+}
+
+void Logger::begin() {
+#if LOG_OUTPUT == LOG_OUTPUT_UART
+    Serial1.begin(LOG_UART_BAUD, SERIAL_8N1, -1, LOG_UART_TX_PIN);
+    sink = writeToLogUART;
+#endif
+}
+
+void Logger::write(uint8_t lineLevel, const char* tag, const char* format, ...) {
+    if (sink == nullptr) return;
+
+    // Formatted on the stack, so any task may log
+    char text[LOG_LINE_MAX];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length < 0) return;
+
+    if ((size_t)length >= sizeof(text)) length = sizeof(text) - 1;
+    while (length > 0 && (text[length - 1] == '\n' || text[length - 1] == '\r')) {
+        text[--length] = '\0';
+    }
+
+    if (sink(lineLevel, tag, text, length)) {
+        linesWritten++;
+    }
+}
+
+const char* Logger::levelName(uint8_t lineLevel) {
+    switch (lineLevel) {
+        case LOG_LEVEL_ERROR: return "error";
+        case LOG_LEVEL_WARN: return "warn";
+        case LOG_LEVEL_INFO: return "info";
+        case LOG_LEVEL_DEBUG: return "debug";
+        default: return "none";
+    }
+}
+
+bool Logger::parseLevel(const char* name, uint8_t& lineLevel) {
+    for (uint8_t candidate = LOG_LEVEL_NONE; candidate <= LOG_LEVEL_DEBUG; candidate++) {
+        if (strcmp(name, levelName(candidate)) == 0) {
+            lineLevel = candidate;
+            return true;
+        }
+    }
+    return false;
+}
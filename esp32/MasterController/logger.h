@@ -0,0 +1,78 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ============================================================================
+// Logger
+// Leveled log lines kept off the Pi protocol stream. Each line has a level
+// and a tag ("LED", "UART", ...) and goes to the sink chosen by LOG_OUTPUT:
+// UARTComm registers itself as the sink for LOG_OUTPUT_PROTOCOL, and
+// LOG_OUTPUT_UART writes plain text to a second hardware UART.
+//
+// Two filters: calls above LOG_LEVEL_COMPILED are compiled out, and calls
+// above the runtime level return before formatting anything.
+// ============================================================================
+
+// Receives one formatted line (no trailing newline, NUL-terminated).
+// Returns false if the line was dropped.
+typedef bool (*LogSink)(uint8_t level, const char* tag, const char* text, size_t length);
+
+class Logger {
+public:
+    Logger();
+
+    void begin();
+    void setSink(LogSink newSink) { sink = newSink; }
+
+    // Runtime level - LOG_LEVEL_NONE .. LOG_LEVEL_DEBUG
+    void setLevel(uint8_t newLevel) { level = newLevel; }
+    uint8_t getLevel() const { return level; }
+    bool isEnabled(uint8_t lineLevel) const { return lineLevel <= level; }
+
+    void write(uint8_t lineLevel, const char* tag, const char* format, ...) __attribute__((format(printf, 4, 5)));
+
+    unsigned long getLinesWritten() const { return linesWritten; } // Accepted by the sink
+
+    // "error", "warn", "info", "debug", "none"
+    static const char* levelName(uint8_t lineLevel);
+    static bool parseLevel(const char* name, uint8_t& lineLevel);
+
+private:
+    LogSink sink;
+    uint8_t level;
+    unsigned long linesWritten;
+};
+
+// Global instance (defined in .cpp file)
+extern Logger logger;
+
+#define LOG_AT(lineLevel, tag, ...) \
+    do { if (logger.isEnabled(lineLevel)) logger.write(lineLevel, tag, __VA_ARGS__); } while (0)
+
+#if LOG_LEVEL_COMPILED >= LOG_LEVEL_ERROR
+#define LOG_ERROR(tag, ...) LOG_AT(LOG_LEVEL_ERROR, tag, __VA_ARGS__)
+#else
+#define LOG_ERROR(tag, ...) do { } while (0)
+#endif
+
+#if LOG_LEVEL_COMPILED >= LOG_LEVEL_WARN
+#define LOG_WARN(tag, ...) LOG_AT(LOG_LEVEL_WARN, tag, __VA_ARGS__)
+#else
+#define LOG_WARN(tag, ...) do { } while (0)
+#endif
+
+#if LOG_LEVEL_COMPILED >= LOG_LEVEL_INFO
+#define LOG_INFO(tag, ...) LOG_AT(LOG_LEVEL_INFO, tag, __VA_ARGS__)
+#else
+#define LOG_INFO(tag, ...) do { } while (0)
+#endif
+
+#if LOG_LEVEL_COMPILED >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(tag, ...) LOG_AT(LOG_LEVEL_DEBUG, tag, __VA_ARGS__)
+#else
+#define LOG_DEBUG(tag, ...) do { } while (0)
+#endif
+
+#endif // LOGGER_H
@@ -0,0 +1,253 @@
+#ifndef PATTERN_KERNELS_H
+#define PATTERN_KERNELS_H
+
+#include <stdint.h>
+
+// ============================================================================
+// Integer Pattern Kernels
+// Fixed-point, table-driven versions of the LED ring patterns. Header-only
+// and free of Arduino/FastLED dependencies so the same code can be built
+// and benchmarked on the host (see bench/pattern_kernels_bench.cpp).
+//
+// Animation phase is a 16-bit accumulator: 0..65535 covers one full cycle.
+// Pixel is any type with uint8_t r, g, b members (CRGB on the device).
+// Position-dependent kernels write ring LED i to strip[indexMap[i]], so
+// ring rotation and direction cost nothing per pixel. Uniform fills don't
+// care about order and write the ring's strip span directly.
+//
+// Pulse and rainbow stay within 1 LSB (channel for pulse, hue for rainbow)
+// of the float kernels they replaced, with no float math per pixel; the
+// bench checks that against the float reference.
+// ============================================================================
+
+// Pulse level per phase step in 1/65536 units (65535 = full):
+// 0.1 + 0.9 * (sin(phase * 2 * PI) + 1) / 2
+static constexpr uint16_t PULSE_TABLE[256] = {
+    36045, 36769, 37492, 38214, 38935, 39655, 40372, 41087, 41798, 42506, 43211, 43910, 44606, 45296, 45980, 46659,
+    47331, 47996, 48654, 49304, 49947, 50581, 51206, 51823, 52429, 53026, 53613, 54189, 54754, 55308, 55850, 56380,
+    56898, 57404, 57896, 58376, 58842, 59294, 59732, 60156, 60566, 60961, 61340, 61705, 62054, 62387, 62705, 63006,
+    63291, 63560, 63812, 64048, 64266, 64468, 64652, 64819, 64969, 65102, 65217, 65314, 65394, 65456, 65500, 65527,
+    65535, 65527, 65500, 65456, 65394, 65314, 65217, 65102, 64969, 64819, 64652, 64468, 64266, 64048, 63812, 63560,
+    63291, 63006, 62705, 62387, 62054, 61705, 61340, 60961, 60566, 60156, 59732, 59294, 58842, 58376, 57896, 57404,
+    56898, 56380, 55850, 55308, 54754, 54189, 53613, 53026, 52429, 51823, 51206, 50581, 49947, 49304, 48654, 47996,
+    47331, 46659, 45980, 45296, 44606, 43910, 43211, 42506, 41798, 41087, 40372, 39655, 38935, 38214, 37492, 36769,
+    36045, 35321, 34598, 33875, 33154, 32435, 31718, 31003, 30291, 29583, 28879, 28179, 27484, 26794, 26110, 25431,
+    24759, 24094, 23436, 22785, 22143, 21509, 20883, 20267, 19660, 19064, 18477, 17901, 17336, 16782, 16240, 15709,
+    15191, 14686, 14193, 13714, 13248, 12796, 12357, 11933, 11524, 11129, 10749, 10385, 10036,  9703,  9385,  9084,
+     8798,  8530,  8278,  8042,  7823,  7622,  7437,  7270,  7120,  6988,  6873,  6775,  6696,  6634,  6589,  6562,
+     6554,  6562,  6589,  6634,  6696,  6775,  6873,  6988,  7120,  7270,  7437,  7622,  7823,  8042,  8278,  8530,
+     8798,  9084,  9385,  9703, 10036, 10385, 10749, 11129, 11524, 11933, 12357, 12796, 13248, 13714, 14193, 14686,
+    15191, 15709, 16240, 16782, 17336, 17901, 18477, 19064, 19660, 20267, 20883, 21509, 22143, 22785, 23436, 24094,
+    24759, 25431, 26110, 26794, 27484, 28179, 28879, 29583, 30291, 31003, 31718, 32435, 33154, 33875, 34598, 35321
+};
+
+// hsv2rgb_rainbow(CHSV(hue, 255, 255)) for every hue
+static constexpr uint8_t RAINBOW_TABLE[256][3] = {
+    {255,  0,  0}, {253,  2,  0}, {250,  5,  0}, {247,  8,  0}, {245, 10,  0}, {242, 13,  0}, {239, 16,  0}, {237, 18,  0},
+    {234, 21,  0}, {231, 24,  0}, {229, 26,  0}, {226, 29,  0}, {223, 32,  0}, {221, 34,  0}, {218, 37,  0}, {215, 40,  0},
+    {212, 43,  0}, {210, 45,  0}, {207, 48,  0}, {204, 51,  0}, {202, 53,  0}, {199, 56,  0}, {196, 59,  0}, {194, 61,  0},
+    {191, 64,  0}, {188, 67,  0}, {186, 69,  0}, {183, 72,  0}, {180, 75,  0}, {178, 77,  0}, {175, 80,  0}, {172, 83,  0},
+    {171, 85,  0}, {171, 87,  0}, {171, 90,  0}, {171, 93,  0}, {171, 95,  0}, {171, 98,  0}, {171,101,  0}, {171,103,  0},
+    {171,106,  0}, {171,109,  0}, {171,111,  0}, {171,114,  0}, {171,117,  0}, {171,119,  0}, {171,122,  0}, {171,125,  0},
+    {171,128,  0}, {171,130,  0}, {171,133,  0}, {171,136,  0}, {171,138,  0}, {171,141,  0}, {171,144,  0}, {171,146,  0},
+    {171,149,  0}, {171,152,  0}, {171,154,  0}, {171,157,  0}, {171,160,  0}, {171,162,  0}, {171,165,  0}, {171,168,  0},
+    {171,170,  0}, {166,172,  0}, {161,175,  0}, {155,178,  0}, {150,180,  0}, {145,183,  0}, {139,186,  0}, {134,188,  0},
+    {129,191,  0}, {123,194,  0}, {118,196,  0}, {113,199,  0}, {107,202,  0}, {102,204,  0}, { 97,207,  0}, { 91,210,  0},
+    { 86,213,  0}, { 81,215,  0}, { 75,218,  0}, { 70,221,  0}, { 65,223,  0}, { 59,226,  0}, { 54,229,  0}, { 49,231,  0},
+    { 43,234,  0}, { 38,237,  0}, { 33,239,  0}, { 27,242,  0}, { 22,245,  0}, { 17,247,  0}, { 11,250,  0}, {  6,253,  0},
+    {  0,255,  0}, {  0,253,  2}, {  0,250,  5}, {  0,247,  8}, {  0,245, 10}, {  0,242, 13}, {  0,239, 16}, {  0,237, 18},
+    {  0,234, 21}, {  0,231, 24}, {  0,229, 26}, {  0,226, 29}, {  0,223, 32}, {  0,221, 34}, {  0,218, 37}, {  0,215, 40},
+    {  0,212, 43}, {  0,210, 45}, {  0,207, 48}, {  0,204, 51}, {  0,202, 53}, {  0,199, 56}, {  0,196, 59}, {  0,194, 61},
+    {  0,191, 64}, {  0,188, 67}, {  0,186, 69}, {  0,183, 72}, {  0,180, 75}, {  0,178, 77}, {  0,175, 80}, {  0,172, 83},
+    {  0,171, 85}, {  0,166, 90}, {  0,161, 95}, {  0,155,101}, {  0,150,106}, {  0,145,111}, {  0,139,117}, {  0,134,122},
+    {  0,129,127}, {  0,123,133}, {  0,118,138}, {  0,113,143}, {  0,107,149}, {  0,102,154}, {  0, 97,159}, {  0, 91,165},
+    {  0, 86,170}, {  0, 81,175}, {  0, 75,181}, {  0, 70,186}, {  0, 65,191}, {  0, 59,197}, {  0, 54,202}, {  0, 49,207},
+    {  0, 43,213}, {  0, 38,218}, {  0, 33,223}, {  0, 27,229}, {  0, 22,234}, {  0, 17,239}, {  0, 11,245}, {  0,  6,250},
+    {  0,  0,255}, {  2,  0,253}, {  5,  0,250}, {  8,  0,247}, { 10,  0,245}, { 13,  0,242}, { 16,  0,239}, { 18,  0,237},
+    { 21,  0,234}, { 24,  0,231}, { 26,  0,229}, { 29,  0,226}, { 32,  0,223}, { 34,  0,221}, { 37,  0,218}, { 40,  0,215},
+    { 43,  0,212}, { 45,  0,210}, { 48,  0,207}, { 51,  0,204}, { 53,  0,202}, { 56,  0,199}, { 59,  0,196}, { 61,  0,194},
+    { 64,  0,191}, { 67,  0,188}, { 69,  0,186}, { 72,  0,183}, { 75,  0,180}, { 77,  0,178}, { 80,  0,175}, { 83,  0,172},
+    { 85,  0,171}, { 87,  0,169}, { 90,  0,166}, { 93,  0,163}, { 95,  0,161}, { 98,  0,158}, {101,  0,155}, {103,  0,153},
+    {106,  0,150}, {109,  0,147}, {111,  0,145}, {114,  0,142}, {117,  0,139}, {119,  0,137}, {122,  0,134}, {125,  0,131},
+    {128,  0,128}, {130,  0,126}, {133,  0,123}, {136,  0,120}, {138,  0,118}, {141,  0,115}, {144,  0,112}, {146,  0,110},
+    {149,  0,107}, {152,  0,104}, {154,  0,102}, {157,  0, 99}, {160,  0, 96}, {162,  0, 94}, {165,  0, 91}, {168,  0, 88},
+    {170,  0, 85}, {172,  0, 83}, {175,  0, 80}, {178,  0, 77}, {180,  0, 75}, {183,  0, 72}, {186,  0, 69}, {188,  0, 67},
+    {191,  0, 64}, {194,  0, 61}, {196,  0, 59}, {199,  0, 56}, {202,  0, 53}, {204,  0, 51}, {207,  0, 48}, {210,  0, 45},
+    {213,  0, 42}, {215,  0, 40}, {218,  0, 37}, {221,  0, 34}, {223,  0, 32}, {226,  0, 29}, {229,  0, 26}, {231,  0, 24},
+    {234,  0, 21}, {237,  0, 18}, {239,  0, 16}, {242,  0, 13}, {245,  0, 10}, {247,  0,  8}, {250,  0,  5}, {253,  0,  2}
+};
+
+// Pulse level for a 16-bit phase in 1/65536 units, interpolated between
+// table entries - within 4/65536 of the float pulse (bench-checked)
+inline uint32_t patternPulseLevel(uint16_t phase) {
+    uint8_t index = phase >> 8;
+    int32_t frac = phase & 0xFF;
+    int32_t a = PULSE_TABLE[index];
+    int32_t b = PULSE_TABLE[(uint8_t)(index + 1)];
+    return (uint32_t)(a + (((b - a) * frac) >> 8));
+}
+
+// value * level truncated, like (uint8_t)(value * pulse) in scaleBrightness()
+inline uint8_t patternPulseChannel(uint8_t value, uint32_t level) {
+    return (uint8_t)((value * level) >> 16);
+}
+
+template <typename Pixel>
+inline void patternFillSolid(Pixel* out, int count, const Pixel& color) {
+    for (int i = 0; i < count; i++) {
+        out[i] = color;
+    }
+}
+
+template <typename Pixel>
+inline void patternFillPulse(Pixel* out, int count, const Pixel& color, uint16_t phase) {
+    uint32_t level = patternPulseLevel(phase);
+    Pixel pulseColor = color;
+    pulseColor.r = patternPulseChannel(color.r, level);
+    pulseColor.g = patternPulseChannel(color.g, level);
+    pulseColor.b = patternPulseChannel(color.b, level);
+    patternFillSolid(out, count, pulseColor);
+}
+
+// Ring fill: activeCount LEDs in color, the rest at 1/8 brightness
+template <typename Pixel>
+inline void patternFillRing(Pixel* strip, const uint16_t* indexMap, int count, int activeCount, const Pixel& color) {
+    Pixel background = color;
+    background.r = color.r >> 3;
+    background.g = color.g >> 3;
+    background.b = color.b >> 3;
+    
+    for (int i = 0; i < count; i++) {
+        strip[indexMap[i]] = (i < activeCount) ? color : background;
+    }
+}
+
+// Ring fill with a sub-LED edge: position is the fill point in 1/256 LED
+// steps. Whole LEDs below it are lit, the boundary LED is blended between
+// background and color by the fractional part.
+template <typename Pixel>
+inline void patternFillRingSmooth(Pixel* strip, const uint16_t* indexMap, int count, uint32_t position, const Pixel& color) {
+    Pixel background = color;
+    background.r = color.r >> 3;
+    background.g = color.g >> 3;
+    background.b = color.b >> 3;
+    
+    int fullCount = position >> 8;
+    uint8_t fraction = position & 0xFF;
+    
+    for (int i = 0; i < count; i++) {
+        strip[indexMap[i]] = (i < fullCount) ? color : background;
+    }
+    
+    if (fraction && fullCount < count) {
+        Pixel& edge = strip[indexMap[fullCount]];
+        edge.r = background.r + (((color.r - background.r) * fraction) >> 8);
+        edge.g = background.g + (((color.g - background.g) * fraction) >> 8);
+        edge.b = background.b + (((color.b - background.b) * fraction) >> 8);
+    }
+}
+
+// Level meter: activeCount LEDs lit by zone (color below warnStart, warnColor
+// up to clipStart, clipColor above), plus a single peak-hold LED at peakIndex
+// (-1 for none). Unlit LEDs are off.
+template <typename Pixel>
+inline void patternFillMeter(Pixel* strip, const uint16_t* indexMap, int count, int activeCount, int peakIndex,
+                             const Pixel& color, const Pixel& warnColor, const Pixel& clipColor,
+                             int warnStart, int clipStart) {
+    Pixel off = color;
+    off.r = 0;
+    off.g = 0;
+    off.b = 0;
+    
+    for (int i = 0; i < count; i++) {
+        if (i < activeCount || i == peakIndex) {
+            strip[indexMap[i]] = (i >= clipStart) ? clipColor : (i >= warnStart) ? warnColor : color;
+        } else {
+            strip[indexMap[i]] = off;
+        }
+    }
+}
+
+// Blend two pixels: weight 0 keeps from, 256 gives to. Red and blue are
+// packed as 0x00RR00BB so they share one multiply; neither can carry into
+// the other since each product stays below 0x10000.
+template <typename Pixel>
+inline Pixel patternBlend(const Pixel& from, const Pixel& to, uint16_t weight) {
+    uint32_t inverse = 256 - weight;
+    uint32_t rb = (((uint32_t)from.r << 16) | from.b) * inverse + (((uint32_t)to.r << 16) | to.b) * weight;
+    uint32_t g = (uint32_t)from.g * inverse + (uint32_t)to.g * weight;
+    
+    Pixel out = from;
+    out.r = (uint8_t)(rb >> 24);
+    out.g = (uint8_t)(g >> 8);
+    out.b = (uint8_t)(rb >> 8);
+    return out;
+}
+
+// Alpha (0-255) as a patternBlend() weight (0-256)
+inline uint16_t patternAlphaWeight(uint8_t alpha) {
+    return alpha + (alpha >> 7);
+}
+
+// Crossfade a rendered ring from an earlier frame: each LED becomes
+// from -> current at weight. from is indexed like strip.
+template <typename Pixel>
+inline void patternCrossfade(Pixel* strip, const uint16_t* indexMap, int count, const Pixel* from, uint16_t weight) {
+    for (int i = 0; i < count; i++) {
+        uint16_t index = indexMap[i];
+        strip[index] = patternBlend(from[index], strip[index], weight);
+    }
+}
+
+// Blend color over ring LEDs first..last (inclusive, clamped to the ring)
+template <typename Pixel>
+inline void patternOverlaySpan(Pixel* strip, const uint16_t* indexMap, int count, int first, int last,
+                               const Pixel& color, uint16_t weight) {
+    if (first < 0) first = 0;
+    if (last >= count) last = count - 1;
+    
+    for (int i = first; i <= last; i++) {
+        Pixel& out = strip[indexMap[i]];
+        out = patternBlend(out, color, weight);
+    }
+}
+
+// Rainbow spread once around the ring, rotated by phase
+template <typename Pixel>
+inline void patternFillRainbow(Pixel* strip, const uint16_t* indexMap, int count, uint16_t phase) {
+    if (count <= 0) return;
+    
+    // LED i sits at p = phase / 65536 + i / count, less one cycle once p
+    // passes 1, and its hue is 255 * p truncated. p is tracked exactly as
+    // position / denominator, and the hue as hue + remainder / denominator,
+    // stepping without a division per LED.
+    uint32_t denominator = 65536UL * count;
+    uint32_t position = (uint32_t)phase * count;
+    uint64_t startHue = (uint64_t)position * 255;
+    uint32_t hue = (uint32_t)(startHue / denominator);
+    uint32_t remainder = (uint32_t)(startHue % denominator);
+    uint32_t hueStep = (255UL * 65536) / denominator;
+    uint32_t remainderStep = (255UL * 65536) % denominator;
+    
+    for (int i = 0; i < count; i++) {
+        uint8_t ledHue = (uint8_t)hue;
+        Pixel& out = strip[indexMap[i]];
+        out.r = RAINBOW_TABLE[ledHue][0];
+        out.g = RAINBOW_TABLE[ledHue][1];
+        out.b = RAINBOW_TABLE[ledHue][2];
+        
+        position += 65536;
+        hue += hueStep;
+        remainder += remainderStep;
+        if (remainder >= denominator) {
+            remainder -= denominator;
+            hue++;
+        }
+        if (position > denominator) {
+            position -= denominator;
+            hue -= 255;
+        }
+    }
+}
+
+#endif // PATTERN_KERNELS_H
@@ -0,0 +1,56 @@
+#ifndef RING_LAYOUT_H
+#define RING_LAYOUT_H
+
+#include <stdint.h>
+#include "config.h"
+
+// ============================================================================
+// Ring Layout
+// Physical geometry of the strip outputs and of every encoder ring. The
+// frame buffer is the strips laid end to end; each ring must sit entirely
+// on one strip. Renderers work in logical ring order (LED 0 = start of the
+// value arc, clockwise); the mapping to strip positions is precomputed
+// from these tables at begin().
+// ============================================================================
+
+struct StripGeometry {
+    uint16_t start;     // First frame buffer LED driven by this strip output
+    uint16_t count;     // LEDs on this strip
+};
+
+struct RingGeometry {
+    uint16_t start;     // First strip LED belonging to this ring
+    uint8_t count;      // Number of LEDs in the ring
+    uint8_t rotation;   // Strip offset (from start) of logical LED 0
+    bool reversed;      // Ring wired counter-clockwise
+};
+
+#if LED_LAYOUT == LED_LAYOUT_16x28
+
+// Two strips of 8 rings each - rings 0-7 on strip 0, rings 8-15 on strip 1
+static const StripGeometry STRIP_LAYOUT[LED_STRIP_COUNT] = {
+    { 0, 224 }, { 224, 224 }
+};
+
+// 16 rings × 28 LEDs, chained in encoder order
+static const RingGeometry RING_LAYOUT[NUM_ENCODERS] = {
+    {   0, 28, 0, false }, {  28, 28, 0, false }, {  56, 28, 0, false }, {  84, 28, 0, false },
+    { 112, 28, 0, false }, { 140, 28, 0, false }, { 168, 28, 0, false }, { 196, 28, 0, false },
+    { 224, 28, 0, false }, { 252, 28, 0, false }, { 280, 28, 0, false }, { 308, 28, 0, false },
+    { 336, 28, 0, false }, { 364, 28, 0, false }, { 392, 28, 0, false }, { 420, 28, 0, false }
+};
+
+#else
+
+// Bench strip: one 72-LED ring
+static const StripGeometry STRIP_LAYOUT[LED_STRIP_COUNT] = {
+    { 0, 72 }
+};
+
+static const RingGeometry RING_LAYOUT[NUM_ENCODERS] = {
+    { 0, 72, 0, false }
+};
+
+#endif
+
+#endif // RING_LAYOUT_H
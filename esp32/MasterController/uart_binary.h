@@ -0,0 +1,187 @@
+#ifndef UART_BINARY_H
+#define UART_BINARY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// Binary UART Frames
+// Compact alternative to JSON lines for the Pi link, switched on with a
+// "protocol" message once both ends have seen "binary_frames" in the
+// capabilities. Header-only and free of Arduino dependencies (see
+// bench/uart_binary_bench.cpp).
+//
+// On the wire:  00 | COBS( type | payload | CRC16 ) | 00
+//   type    - one byte, BIN_MSG_*
+//   payload - packed fields, multi-byte values little-endian
+//   CRC16   - CRC-16/CCITT-FALSE of type + payload, little-endian
+// COBS removes every 0x00 from the frame so 0x00 only ever delimits. The
+// leading delimiter closes anything stray written since the last frame, so
+// it fails the CRC on its own instead of corrupting the next frame.
+//
+// Hot messages have packed forms; everything else travels as BIN_MSG_JSON
+// with the usual JSON text as payload, so it still gets the CRC.
+// ============================================================================
+
+#define BIN_FRAME_DELIMITER 0x00
+#define BIN_CRC_INIT 0xFFFF
+#define BIN_COBS_BLOCK 0xFF        // Longest COBS block incl. its code byte
+
+// ESP32 -> Pi
+#define BIN_MSG_ENCODER 0x01       // id u8, value u16 (0-65535), direction i8, timestamp u16 (millis() & 0xFFFF)
+#define BIN_MSG_STREAM_ACK 0x02    // seq u32, credits u8, flags u8 (bit 0 resync), dropped u32
+#define BIN_MSG_LOG 0x03           // level u8, tag length u8, tag, message text (logger.h)
+
+// Pi -> ESP32
+#define BIN_MSG_LED_UPDATE 0x10    // id u8, r g b, pattern u8 (LEDPattern), value u16
+#define BIN_MSG_LED_BATCH 0x11     // count u8, then count x led_update payload
+#define BIN_MSG_LED_METER 0x12     // first u8, then one level byte per ring
+#define BIN_MSG_LED_STREAM 0x13    // seq u32, target i8, flags u8 (bit 0 key), raw stream ops
+
+// Either direction
+#define BIN_MSG_JSON 0x7F          // JSON message text, no line ending
+
+#define BIN_LED_UPDATE_BYTES 7
+#define BIN_STREAM_HEADER_BYTES 6
+
+inline uint16_t binCrc16Update(uint16_t crc, uint8_t byte) {
+    // Nibble table for polynomial 0x1021
+    static const uint16_t table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+    crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (byte >> 4)]);
+    crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (byte & 0x0F)]);
+    return crc;
+}
+
+inline uint16_t binCrc16(const uint8_t* data, size_t length) {
+    uint16_t crc = BIN_CRC_INIT;
+    for (size_t i = 0; i < length; i++) {
+        crc = binCrc16Update(crc, data[i]);
+    }
+    return crc;
+}
+
+inline uint16_t binGet16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+inline uint32_t binGet32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Decode one COBS frame (without delimiters). out may be in. Returns the
+// decoded length, or -1 if the frame is malformed.
+inline int cobsDecode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t pos = 0;
+    size_t outLength = 0;
+
+    while (pos < length) {
+        uint8_t code = in[pos++];
+        if (code == 0 || pos + code - 1 > length) return -1;
+
+        for (uint8_t i = 1; i < code; i++) {
+            if (in[pos] == 0) return -1;
+            out[outLength++] = in[pos++];
+        }
+
+        // Every block but a full one ends in a zero, except at the very end
+        if (code != BIN_COBS_BLOCK && pos < length) out[outLength++] = 0;
+    }
+
+    return (int)outLength;
+}
+
+// Decode a received frame (without delimiters) into out, which needs length
+// bytes and may be in, and check its CRC. On success type is set and
+// payload/payloadLength point into out past it.
+inline bool binFrameDecode(const uint8_t* in, size_t length, uint8_t* out, uint8_t& type,
+                           const uint8_t*& payload, size_t& payloadLength) {
+    int decoded = cobsDecode(in, length, out);
+    if (decoded < 3) return false;
+
+    size_t bodyLength = decoded - 2;
+    if (binCrc16(out, bodyLength) != binGet16(out + bodyLength)) return false;
+
+    type = out[0];
+    payload = out + 1;
+    payloadLength = bodyLength - 1;
+    return true;
+}
+
+// Streams one frame to sink as it is built - COBS-encoded a block at a time
+// with the CRC kept on the fly, so no frame-sized buffer is needed. Sink is
+// anything with write(const uint8_t*, size_t) (Print on the device).
+template <typename Sink>
+class BinaryFrameWriter {
+public:
+    explicit BinaryFrameWriter(Sink& sink) : sink(sink), length(1), crc(BIN_CRC_INIT), frameBytes(0) { }
+
+    void begin(uint8_t type) {
+        static const uint8_t delimiter = BIN_FRAME_DELIMITER;
+        sink.write(&delimiter, 1);
+        length = 1;
+        crc = BIN_CRC_INIT;
+        frameBytes = 1;
+        put(type);
+    }
+
+    void put(uint8_t byte) {
+        crc = binCrc16Update(crc, byte);
+        encode(byte);
+    }
+
+    void put16(uint16_t value) {
+        put((uint8_t)value);
+        put((uint8_t)(value >> 8));
+    }
+
+    void put32(uint32_t value) {
+        put16((uint16_t)value);
+        put16((uint16_t)(value >> 16));
+    }
+
+    void put(const uint8_t* data, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            put(data[i]);
+        }
+    }
+
+    // Appends the CRC and closes the frame. Returns the bytes written for it.
+    size_t end() {
+        uint16_t frameCrc = crc;
+        encode((uint8_t)frameCrc);
+        encode((uint8_t)(frameCrc >> 8));
+        flush();
+
+        static const uint8_t delimiter = BIN_FRAME_DELIMITER;
+        sink.write(&delimiter, 1);
+        return ++frameBytes;
+    }
+
+private:
+    void encode(uint8_t byte) {
+        if (byte == 0) {
+            flush();
+            return;
+        }
+        block[length++] = byte;
+        if (length == BIN_COBS_BLOCK) flush();
+    }
+
+    void flush() {
+        block[0] = (uint8_t)length;
+        sink.write(block, length);
+        frameBytes += length;
+        length = 1;
+    }
+
+    Sink& sink;
+    uint8_t block[BIN_COBS_BLOCK];
+    size_t length;           // Bytes in block incl. the code byte
+    uint16_t crc;
+    size_t frameBytes;
+};
+
+#endif // UART_BINARY_H
@@ -1,21 +1,62 @@
 #include "uart_comm.h"
+#include "led_controller.h"
+#include "logger.h"
+#include <stdarg.h>
 
 // Global instance
 UARTComm uart;
 
+// Coalescing keys - a newer queued message with the same key replaces the
+// one still waiting
+#define TX_KEY_STATUS 0x0001
+#define TX_KEY_ENCODER 0x0100   // + encoder id
+
+#if LOG_OUTPUT == LOG_OUTPUT_PROTOCOL
+static bool writeLogToPi(uint8_t level, const char* tag, const char* text, size_t length) {
+    return uart.sendLog(level, tag, text, length);
+}
+#endif
+
+unsigned long JsonHeapAllocator::allocations = 0;
+
+void* JsonHeapAllocator::allocate(size_t size) {
+    allocations++;
+    return malloc(size);
+}
+
+void JsonHeapAllocator::deallocate(void* pointer) {
+    free(pointer);
+}
+
+void* JsonHeapAllocator::reallocate(void* pointer, size_t size) {
+    allocations++;
+    return realloc(pointer, size);
+}
+
+UARTComm::UARTComm()
+    : rxDoc(JSON_BUFFER_SIZE), txDoc(JSON_TX_DOC_SIZE), txDropped(0) {
+}
+
 void UARTComm::begin() {
     Serial.begin(UART_BAUD);
     
     // Initialize variables
-    inputBuffer.reserve(UART_BUFFER_SIZE);
+    rxFramer.reset();
     lastHeartbeat = 0;
     lastStatusUpdate = 0;
     isConnected = false;
     messagesSent = 0;
     messagesReceived = 0;
     errors = 0;
+    binaryFraming = false;
+    crcErrors = 0;
+    logDropped = 0;
+    loopTask = xTaskGetCurrentTaskHandle();
     
-    debugPrint("UART Communication initialized");
+#if LOG_OUTPUT == LOG_OUTPUT_PROTOCOL
+    logger.setSink(writeLogToPi);
+#endif
+    LOG_INFO("UART", "UART Communication initialized");
     
     // Send startup message after brief delay
     delay(100);
@@ -33,126 +74,545 @@ void UARTComm::update() {
     if (shouldSendStatus()) {
         sendStatus();
     }
+    
+    // Messages queued elsewhere in the loop go out on the next pass
+    drainTransmitQueue();
 }
 
 void UARTComm::processIncomingData() {
-    while (Serial.available()) {
-        char c = Serial.read();
+    // Read whatever the UART driver holds in one go, then parse every
+    // complete line straight out of the receive buffer
+    int available;
+    while ((available = Serial.available()) > 0) {
+        size_t space;
+        char* dst = rxFramer.writeBuffer(space);
+        size_t count = Serial.readBytes(dst, min((size_t)available, space));
+        rxFramer.commit(count);
         
-        if (c == '\n') {
-            // Process complete message
-            if (inputBuffer.length() > 0) {
-                processMessage(inputBuffer);
-                inputBuffer = "";
-            }
-        } else if (c != '\r') {
-            inputBuffer += c;
-            
-            // Prevent buffer overflow
-            if (inputBuffer.length() >= UART_BUFFER_SIZE - 1) {
-                debugPrint("Buffer overflow - clearing");
-                inputBuffer = "";
-                incrementErrorCount();
+        unsigned long overflowsBefore = rxFramer.getOverflows();
+        const char* line;
+        size_t length;
+        while (rxFramer.nextLine(line, length)) {
+            if (binaryFraming) {
+                processFrame(line, length);
+            } else {
+                processMessage(line, length);
             }
         }
+        
+        // An oversized line is dropped up to its delimiter; the next
+        // message is kept
+        if (rxFramer.getOverflows() != overflowsBefore) {
+            LOG_WARN("UART", "Line exceeds receive buffer - skipping to next message");
+            incrementErrorCount();
+        }
+        
+        if (count == 0) break;
     }
 }
 
-void UARTComm::processMessage(const String& message) {
-    debugPrint("Received: " + message);
+void UARTComm::processMessage(const char* message, size_t length) {
+    LOG_DEBUG("UART", "Received: %.*s", (int)length, message);
     messagesReceived++;
     isConnected = true;  // Mark as connected when we receive messages
     
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-    DeserializationError error = deserializeJson(doc, message);
+    JsonDocument& doc = rxDoc;
+    DeserializationError error = deserializeJson(doc, message, length);
     
     if (error) {
-        debugPrint("JSON parse error: " + String(error.c_str()));
-        sendError("JSON parse failed: " + String(error.c_str()));
+        LOG_WARN("UART", "JSON parse error: %s", error.c_str());
+        sendError("JSON parse failed: %s", error.c_str());
         incrementErrorCount();
         return;
     }
     
     // Check for required 'type' field
     if (!doc.containsKey("type")) {
-        debugPrint("Message missing 'type' field");
+        LOG_WARN("UART", "Message missing 'type' field");
         sendError("Message missing 'type' field");
         incrementErrorCount();
         return;
     }
     
-    String messageType = doc["type"];
+    const char* messageType = doc["type"] | "";
     
     // Route message to appropriate handler
-    if (messageType == MSG_TYPE_LED_UPDATE) {
+    if (strcmp(messageType, MSG_TYPE_LED_UPDATE) == 0) {
         handleLEDUpdate(doc);
-    } else if (messageType == "system_command") {
+    } else if (strcmp(messageType, MSG_TYPE_LED_BATCH) == 0) {
+        handleLEDBatch(doc);
+    } else if (strcmp(messageType, MSG_TYPE_LED_PROGRAM) == 0) {
+        handleLEDProgram(doc);
+    } else if (strcmp(messageType, MSG_TYPE_LED_PROGRAM_CMD) == 0) {
+        handleLEDProgramCommand(doc);
+    } else if (strcmp(messageType, MSG_TYPE_LED_STREAM) == 0) {
+        handleLEDStream(doc);
+    } else if (strcmp(messageType, MSG_TYPE_LED_METER) == 0) {
+        handleLEDMeter(doc);
+    } else if (strcmp(messageType, MSG_TYPE_LED_OVERLAY) == 0) {
+        handleLEDOverlay(doc);
+    } else if (strcmp(messageType, "system_command") == 0) {
         handleSystemCommand(doc);
+    } else if (strcmp(messageType, MSG_TYPE_PROTOCOL) == 0) {
+        handleProtocol(doc);
+    } else {
+        LOG_WARN("UART", "Unknown message type: %s", messageType);
+        sendError("Unknown message type: %s", messageType);
+    }
+}
+
+void UARTComm::processFrame(const char* frame, size_t length) {
+    uint8_t type;
+    const uint8_t* payload;
+    size_t payloadLength;
+    if (!binFrameDecode((const uint8_t*)frame, length, rxFrame, type, payload, payloadLength)) {
+        // A Pi that lost track of the framing can still get through with a
+        // JSON line between 0x00 delimiters (e.g. to switch back to JSON)
+        if (frame[0] == '{') {
+            processMessage(frame, length);
+            return;
+        }
+        crcErrors++;
+        incrementErrorCount();
+        LOG_WARN("UART", "Binary frame malformed or failed CRC - dropped");
+        return;
+    }
+    
+    if (type == BIN_MSG_JSON) {
+        processMessage((const char*)payload, payloadLength);
+        return;
+    }
+    
+    LOG_DEBUG("UART", "Received frame 0x%02X (%u bytes)", type, (unsigned)payloadLength);
+    messagesReceived++;
+    isConnected = true;
+    
+    switch (type) {
+        case BIN_MSG_LED_UPDATE:
+            handleBinaryLEDUpdate(payload, payloadLength);
+            break;
+        case BIN_MSG_LED_BATCH:
+            handleBinaryLEDBatch(payload, payloadLength);
+            break;
+        case BIN_MSG_LED_METER:
+            handleBinaryLEDMeter(payload, payloadLength);
+            break;
+        case BIN_MSG_LED_STREAM:
+            handleBinaryLEDStream(payload, payloadLength);
+            break;
+        default:
+            sendError("Unknown binary message type: %u", type);
+            break;
+    }
+}
+
+void UARTComm::handleProtocol(JsonDocument& doc) {
+    // {"type":"protocol","framing":"binary"|"json"}
+    // Answered in the current framing; both directions switch right after
+    const char* framing = doc["framing"] | "";
+    bool binary;
+    if (strcmp(framing, "binary") == 0) {
+        binary = true;
+    } else if (strcmp(framing, "json") == 0) {
+        binary = false;
     } else {
-        debugPrint("Unknown message type: " + messageType);
-        sendError("Unknown message type: " + messageType);
+        sendError("Unsupported framing: %s", framing);
+        return;
+    }
+    
+    JsonDocument& reply = beginMessage(MSG_TYPE_PROTOCOL);
+    reply["framing"] = binary ? "binary" : "json";
+    sendJSON(reply);
+    
+    setBinaryFraming(binary);
+}
+
+void UARTComm::setBinaryFraming(bool enable) {
+    binaryFraming = enable;
+    rxFramer.setDelimiter(enable ? (char)BIN_FRAME_DELIMITER : '\n');
+    LOG_INFO("UART", "Switched to %s framing", enable ? "binary" : "JSON");
+}
+
+void UARTComm::handleBinaryLEDUpdate(const uint8_t* payload, size_t length) {
+    if (length != BIN_LED_UPDATE_BYTES) {
+        sendError("Binary LED update has wrong length: %u", (unsigned)length);
+        return;
     }
+    
+    LEDRingUpdate update;
+    unpackLEDUpdate(payload, update);
+    onLEDUpdateReceived(update.encoderId, update.r, update.g, update.b, update.pattern, update.value);
+}
+
+void UARTComm::handleBinaryLEDBatch(const uint8_t* payload, size_t length) {
+    // Same all-or-nothing rule as led_batch
+    int count = length > 0 ? payload[0] : 0;
+    if (count == 0 || count > NUM_ENCODERS || length != 1 + (size_t)count * BIN_LED_UPDATE_BYTES) {
+        sendError("Binary LED batch malformed");
+        return;
+    }
+    
+    LEDRingUpdate updates[NUM_ENCODERS];
+    for (int i = 0; i < count; i++) {
+        unpackLEDUpdate(payload + 1 + i * BIN_LED_UPDATE_BYTES, updates[i]);
+        if (updates[i].encoderId >= NUM_ENCODERS) {
+            sendError("LED batch entry %d has invalid encoder_id", i);
+            return;
+        }
+    }
+    
+    onLEDBatchReceived(updates, count);
 }
 
-void UARTComm::handleLEDUpdate(DynamicJsonDocument& doc) {
+void UARTComm::handleBinaryLEDMeter(const uint8_t* payload, size_t length) {
+    if (length < 1 || length - 1 > NUM_ENCODERS) {
+        sendError("LED meter levels invalid");
+        return;
+    }
+    
+    onLEDMeterReceived(payload[0], payload + 1, length - 1);
+}
+
+void UARTComm::handleBinaryLEDStream(const uint8_t* payload, size_t length) {
+    if (length < BIN_STREAM_HEADER_BYTES) {
+        sendError("LED stream missing required fields");
+        return;
+    }
+    
+    uint32_t seq = binGet32(payload);
+    int target = (int8_t)payload[4];
+    if (target >= NUM_ENCODERS) {
+        sendError("LED stream has invalid target: %d", target);
+        return;
+    }
+    
+    // Raw ops - no base64 step. Oversized payloads count as dropped.
+    size_t opsLength = length - BIN_STREAM_HEADER_BYTES;
+    if (opsLength > LED_STREAM_MAX_BYTES) {
+        LOG_WARN("UART", "LED stream payload invalid");
+        onLEDStreamReceived(target, seq, false, nullptr, 0);
+        return;
+    }
+    
+    onLEDStreamReceived(target, seq, payload[5] & 0x01, payload + BIN_STREAM_HEADER_BYTES, opsLength);
+}
+
+void UARTComm::unpackLEDUpdate(const uint8_t* src, LEDRingUpdate& update) {
+    update.encoderId = src[0];
+    update.r = src[1];
+    update.g = src[2];
+    update.b = src[3];
+    
+    // Only the patterns led_update can name; anything else is solid, as with
+    // an unknown pattern string
+    switch (src[4]) {
+        case PATTERN_OFF:
+        case PATTERN_SOLID:
+        case PATTERN_RING_FILL:
+        case PATTERN_PULSE:
+        case PATTERN_RAINBOW:
+        case PATTERN_METER:
+            update.pattern = (LEDPattern)src[4];
+            break;
+        default:
+            update.pattern = PATTERN_SOLID;
+            break;
+    }
+    update.value = binGet16(src + 5) / 65535.0f;
+}
+
+void UARTComm::handleLEDUpdate(JsonDocument& doc) {
     // Extract LED update parameters
-    if (!doc.containsKey("encoder_id") || !doc.containsKey("color") || !doc.containsKey("pattern")) {
+    LEDRingUpdate update;
+    if (!parseLEDUpdate(doc.as<JsonVariant>(), update)) {
         sendError("LED update missing required fields");
         return;
     }
     
-    int encoderId = doc["encoder_id"];
-    uint8_t r = doc["color"]["r"] | 0;
-    uint8_t g = doc["color"]["g"] | 0;  
-    uint8_t b = doc["color"]["b"] | 0;
-    String patternStr = doc["pattern"];
-    float value = doc["value"] | 0.0;
+    // Call callback function
+    onLEDUpdateReceived(update.encoderId, update.r, update.g, update.b, update.pattern, update.value);
+}
+
+void UARTComm::handleLEDBatch(JsonDocument& doc) {
+    // {"type":"led_batch","updates":[{led_update fields}, ...]}
+    JsonArray entries = doc["updates"];
+    if (entries.isNull() || entries.size() == 0) {
+        sendError("LED batch missing updates");
+        return;
+    }
+    if (entries.size() > NUM_ENCODERS) {
+        sendError("LED batch too large: %u", (unsigned)entries.size());
+        return;
+    }
     
-    // Convert pattern string to enum
-    LEDPattern pattern = PATTERN_SOLID;
-    if (patternStr == "off") pattern = PATTERN_OFF;
-    else if (patternStr == "ring_fill") pattern = PATTERN_RING_FILL;
-    else if (patternStr == "pulse") pattern = PATTERN_PULSE;
-    else if (patternStr == "rainbow") pattern = PATTERN_RAINBOW;
+    // Validate every entry before applying any, so a batch lands whole or
+    // not at all
+    LEDRingUpdate updates[NUM_ENCODERS];
+    int count = 0;
+    for (JsonVariant entry : entries) {
+        if (!parseLEDUpdate(entry, updates[count])) {
+            sendError("LED batch entry %d missing required fields", count);
+            return;
+        }
+        if (updates[count].encoderId < 0 || updates[count].encoderId >= NUM_ENCODERS) {
+            sendError("LED batch entry %d has invalid encoder_id", count);
+            return;
+        }
+        count++;
+    }
     
-    // Call callback function
-    onLEDUpdateReceived(encoderId, r, g, b, pattern, value);
+    onLEDBatchReceived(updates, count);
+}
+
+void UARTComm::handleLEDProgram(JsonDocument& doc) {
+    // {"type":"led_program","encoder_id":0,"loop":"repeat","start":true,
+    //  "keyframes":[{"color":{...},"value":1.0,"duration_ms":500,"easing":"in_out"}, ...]}
+    // encoder_id -1 loads the program on every ring
+    JsonArray frames = doc["keyframes"];
+    if (!doc.containsKey("encoder_id") || frames.isNull() || frames.size() == 0) {
+        sendError("LED program missing required fields");
+        return;
+    }
+    if (frames.size() > LED_PROGRAM_MAX_KEYFRAMES) {
+        sendError("LED program has too many keyframes: %u", (unsigned)frames.size());
+        return;
+    }
+    
+    LEDProgram program;
+    program.count = 0;
+    for (JsonVariant frame : frames) {
+        if (!parseKeyframe(frame, program.keyframes[program.count])) {
+            sendError("LED program keyframe %d missing color", program.count);
+            return;
+        }
+        program.count++;
+    }
+    
+    const char* loopStr = doc["loop"] | "once";
+    if (strcmp(loopStr, "repeat") == 0) program.loop = PROGRAM_REPEAT;
+    else if (strcmp(loopStr, "pingpong") == 0) program.loop = PROGRAM_PINGPONG;
+    else program.loop = PROGRAM_ONCE;
+    
+    onLEDProgramReceived(doc["encoder_id"], program, doc["start"] | true);
+}
+
+void UARTComm::handleLEDProgramCommand(JsonDocument& doc) {
+    // {"type":"led_program_cmd","encoder_id":0,"command":"start"|"stop"}
+    // {"type":"led_program_cmd","encoder_id":0,"command":"retarget",
+    //  "color":{...},"value":0.5,"duration_ms":300,"easing":"out"}
+    if (!doc.containsKey("encoder_id") || !doc.containsKey("command")) {
+        sendError("LED program command missing required fields");
+        return;
+    }
+    
+    const char* command = doc["command"] | "";
+    ProgramKeyframe target = {0, 0, 0, 0, EASE_LINEAR, 0};
+    if (strcmp(command, "retarget") == 0 && !parseKeyframe(doc.as<JsonVariant>(), target)) {
+        sendError("LED program retarget missing color");
+        return;
+    }
+    
+    onLEDProgramCommand(doc["encoder_id"], command, target);
 }
 
-void UARTComm::handleSystemCommand(DynamicJsonDocument& doc) {
-    String command = doc["command"] | "";
-    String parameter = doc["parameter"] | "";
+void UARTComm::handleLEDMeter(JsonDocument& doc) {
+    // {"type":"led_meter","first":0,"levels":"<base64, one byte per ring>"}
+    // 16 rings is 24 base64 characters - about 60 bytes per frame on the wire
+    const char* data = doc["levels"];
+    if (data == nullptr) {
+        sendError("LED meter missing levels");
+        return;
+    }
+    
+    uint8_t levels[NUM_ENCODERS];
+    int count = streamBase64Decode(data, strlen(data), levels, sizeof(levels));
+    if (count < 0) {
+        sendError("LED meter levels invalid");
+        return;
+    }
+    
+    onLEDMeterReceived(doc["first"] | 0, levels, count);
+}
+
+void UARTComm::handleLEDOverlay(JsonDocument& doc) {
+    // {"type":"led_overlay","encoder_id":0,"slot":0,"kind":"marker"|"range"|"none",
+    //  "color":{...},"start":0.5,"end":0.8,"alpha":255}
+    if (!doc.containsKey("encoder_id") || !doc.containsKey("kind")) {
+        sendError("LED overlay missing required fields");
+        return;
+    }
+    
+    const char* kind = doc["kind"] | "";
+    LEDOverlay overlay = {OVERLAY_NONE, 0, 0, 0, 255, 0, 0};
+    if (strcmp(kind, "marker") == 0) {
+        overlay.kind = OVERLAY_MARKER;
+    } else if (strcmp(kind, "range") == 0) {
+        overlay.kind = OVERLAY_RANGE;
+    } else if (strcmp(kind, "none") != 0) {
+        sendError("Unknown LED overlay kind: %s", kind);
+        return;
+    }
+    
+    if (overlay.kind != OVERLAY_NONE) {
+        if (!doc.containsKey("color")) {
+            sendError("LED overlay missing color");
+            return;
+        }
+        overlay.r = doc["color"]["r"] | 0;
+        overlay.g = doc["color"]["g"] | 0;
+        overlay.b = doc["color"]["b"] | 0;
+        overlay.alpha = doc["alpha"] | 255;
+        overlay.start = (uint16_t)(constrain(doc["start"] | 0.0f, 0.0f, 1.0f) * 65535);
+        overlay.end = (uint16_t)(constrain(doc["end"] | 0.0f, 0.0f, 1.0f) * 65535);
+    }
+    
+    onLEDOverlayReceived(doc["encoder_id"], doc["slot"] | 0, overlay);
+}
+
+void UARTComm::handleLEDStream(JsonDocument& doc) {
+    // {"type":"led_stream","seq":12,"target":-1,"key":false,"data":"<base64 ops>"}
+    // target is an encoder id, or -1 for the whole strip (see led_stream.h)
+    const char* data = doc["data"];
+    if (!doc.containsKey("seq") || data == nullptr) {
+        sendError("LED stream missing required fields");
+        return;
+    }
+    
+    int target = doc["target"] | -1;
+    if (target >= NUM_ENCODERS) {
+        sendError("LED stream has invalid target: %d", target);
+        return;
+    }
+    
+    // A payload that fails to decode is still passed on (with null ops) so
+    // it is counted as dropped and the next ack asks for a key frame
+    int length = streamBase64Decode(data, strlen(data), streamBytes, sizeof(streamBytes));
+    if (length < 0) {
+        LOG_WARN("UART", "LED stream payload invalid");
+        onLEDStreamReceived(target, doc["seq"], false, nullptr, 0);
+        return;
+    }
+    
+    onLEDStreamReceived(target, doc["seq"], doc["key"] | false, streamBytes, length);
+}
+
+bool UARTComm::parseKeyframe(JsonVariant src, ProgramKeyframe& keyframe) {
+    if (!src.containsKey("color")) return false;
+    
+    keyframe.r = src["color"]["r"] | 0;
+    keyframe.g = src["color"]["g"] | 0;
+    keyframe.b = src["color"]["b"] | 0;
+    float value = src["value"] | 1.0;
+    keyframe.level = (uint8_t)(constrain(value, 0.0, 1.0) * 255);
+    keyframe.durationMs = (uint16_t)constrain((long)(src["duration_ms"] | 0L), 0L, 65535L);
+    keyframe.easing = parseEasing(src["easing"] | "linear");
+    return true;
+}
+
+ProgramEasing UARTComm::parseEasing(const char* easingStr) {
+    if (strcmp(easingStr, "in") == 0) return EASE_IN;
+    if (strcmp(easingStr, "out") == 0) return EASE_OUT;
+    if (strcmp(easingStr, "in_out") == 0) return EASE_IN_OUT;
+    if (strcmp(easingStr, "step") == 0) return EASE_STEP;
+    return EASE_LINEAR;
+}
+
+bool UARTComm::parseLEDUpdate(JsonVariant src, LEDRingUpdate& update) {
+    if (!src.containsKey("encoder_id") || !src.containsKey("color") || !src.containsKey("pattern")) {
+        return false;
+    }
+    
+    update.encoderId = src["encoder_id"];
+    update.r = src["color"]["r"] | 0;
+    update.g = src["color"]["g"] | 0;
+    update.b = src["color"]["b"] | 0;
+    update.pattern = parsePattern(src["pattern"] | "");
+    update.value = src["value"] | 0.0;
+    return true;
+}
+
+LEDPattern UARTComm::parsePattern(const char* patternStr) {
+    // Convert pattern string to enum
+    if (strcmp(patternStr, "off") == 0) return PATTERN_OFF;
+    if (strcmp(patternStr, "ring_fill") == 0) return PATTERN_RING_FILL;
+    if (strcmp(patternStr, "pulse") == 0) return PATTERN_PULSE;
+    if (strcmp(patternStr, "rainbow") == 0) return PATTERN_RAINBOW;
+    if (strcmp(patternStr, "meter") == 0) return PATTERN_METER;
+    return PATTERN_SOLID;
+}
+
+void UARTComm::handleSystemCommand(JsonDocument& doc) {
+    const char* command = doc["command"] | "";
+    const char* parameter = doc["parameter"] | "";
     
     onSystemCommandReceived(command, parameter);
 }
 
-void UARTComm::sendMessage(const String& message) {
-    Serial.println(message);
-    messagesSent++;
-    debugPrint("Sent: " + message);
+void UARTComm::sendMessage(const char* message) {
+    txQueue.begin(TX_KEY_NONE);
+    txQueue.write((const uint8_t*)message, strlen(message));
+    txQueue.write((const uint8_t*)"\r\n", 2);
+    commitMessage();
 }
 
-void UARTComm::sendJSON(DynamicJsonDocument& doc) {
-    String message;
-    serializeJson(doc, message);
-    sendMessage(message);
+void UARTComm::sendJSON(JsonDocument& doc, uint16_t key) {
+    // Serialized straight into the scratch buffer, CRLF appended in place
+    size_t length = serializeJson(doc, txBuffer, sizeof(txBuffer) - 2);
+    if (doc.overflowed() || length >= sizeof(txBuffer) - 3) {
+        txDropped++;
+        incrementErrorCount();
+        LOG_WARN("UART", "Outgoing message too large - dropped");
+        return;
+    }
+    
+    txQueue.begin(key);
+    if (binaryFraming) {
+        BinaryFrameWriter<UARTTxQueue> frame(txQueue);
+        frame.begin(BIN_MSG_JSON);
+        frame.put((const uint8_t*)txBuffer, length);
+        frame.end();
+    } else {
+        txBuffer[length] = '\r';
+        txBuffer[length + 1] = '\n';
+        txQueue.write((const uint8_t*)txBuffer, length + 2);
+    }
+    commitMessage();
+}
+
+void UARTComm::commitMessage() {
+    // A full queue drops the new message (counted by the queue)
+    if (txQueue.commit()) {
+        messagesSent++;
+    }
+}
+
+void UARTComm::drainTransmitQueue() {
+    // Only as much as the UART driver takes without blocking
+    int space = Serial.availableForWrite();
+    if (space > 0) {
+        txQueue.drain(Serial, space);
+    }
+}
+
+JsonDocument& UARTComm::beginMessage(const char* type) {
+    txDoc.clear();
+    txDoc["type"] = type;
+    return txDoc;
 }
 
 void UARTComm::sendStartup() {
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-    doc["type"] = MSG_TYPE_STARTUP;
+    JsonDocument& doc = beginMessage(MSG_TYPE_STARTUP);
     doc["device_id"] = DEVICE_ID;
     doc["firmware_version"] = FIRMWARE_VERSION;
     doc["status"] = "ready";
-    doc["capabilities"] = "led_control,i2c_encoders,uart_comm";
+    doc["capabilities"] = "led_control,led_batch,led_program,led_stream,led_meter,led_overlay,i2c_encoders,uart_comm,binary_frames";
     doc["timestamp"] = millis();
     
     sendJSON(doc);
 }
 
 void UARTComm::sendHeartbeat() {
-    DynamicJsonDocument doc(256);
-    doc["type"] = MSG_TYPE_HEARTBEAT;
+    JsonDocument& doc = beginMessage(MSG_TYPE_HEARTBEAT);
     doc["device_id"] = DEVICE_ID;
     doc["status"] = "alive";
     doc["uptime"] = millis();
@@ -163,23 +623,91 @@ void UARTComm::sendHeartbeat() {
 }
 
 void UARTComm::sendStatus() {
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-    doc["type"] = MSG_TYPE_STATUS;
+    JsonDocument& doc = beginMessage(MSG_TYPE_STATUS);
     doc["device_id"] = DEVICE_ID;
     doc["uptime"] = millis();
     doc["free_memory"] = ESP.getFreeHeap();
     doc["messages_sent"] = messagesSent;
     doc["messages_received"] = messagesReceived;
     doc["errors"] = errors;
+    doc["uart_rx_overflows"] = rxFramer.getOverflows();
+    doc["uart_tx_dropped"] = txDropped;
+    doc["json_heap_allocs"] = JsonHeapAllocator::allocations;
+    doc["uart_framing"] = binaryFraming ? "binary" : "json";
+    doc["uart_crc_errors"] = crcErrors;
+    doc["log_level"] = Logger::levelName(logger.getLevel());
+    doc["log_lines"] = logger.getLinesWritten();
+    doc["log_dropped"] = logDropped;
+    doc["uart_tx_queue_depth"] = txQueue.getDepth();
+    doc["uart_tx_queue_max"] = txQueue.getMaxDepth();
+    doc["uart_tx_queue_bytes"] = txQueue.getBytes();
+    doc["uart_tx_queue_drops"] = txQueue.getDrops();
+    doc["uart_tx_coalesced"] = txQueue.getCoalesced();
+    doc["led_brightness"] = ledController.getOutputBrightness();
+    doc["led_frames_rendered"] = ledController.getFramesRendered();
+    doc["led_frames_skipped"] = ledController.getFramesSkipped();
+    doc["led_updates_coalesced"] = ledController.getUpdatesCoalesced();
+    doc["led_encoder_latency_us"] = ledController.getEncoderLatencyAvgUs();
+    doc["led_encoder_latency_max_us"] = ledController.getEncoderLatencyMaxUs();
+    doc["led_refreshes"] = ledController.getRefreshCount();
+    doc["led_refresh_us"] = ledController.getRefreshTotalUs();
+    doc["led_stream_frames"] = ledController.getStreamFrames();
+    doc["led_stream_dropped"] = ledController.getStreamDropped();
+    doc["led_stream_superseded"] = ledController.getStreamSuperseded();
+    
+    JsonArray stripShowTimes = doc.createNestedArray("led_strip_show_us");
+    for (int i = 0; i < ledController.getStripCount(); i++) {
+        stripShowTimes.add(ledController.getStripShowMicros(i));
+    }
+    addLEDStats(doc.createNestedObject("led_stats"));
     doc["timestamp"] = millis();
     
-    sendJSON(doc);
+    sendJSON(doc, TX_KEY_STATUS);
     lastStatusUpdate = millis();
 }
 
-void UARTComm::sendError(const String& errorMsg) {
-    DynamicJsonDocument doc(512);
-    doc["type"] = MSG_TYPE_ERROR;
+void UARTComm::sendLEDStats() {
+    JsonDocument& doc = beginMessage(MSG_TYPE_LED_STATS);
+    doc["device_id"] = DEVICE_ID;
+    addLEDStats(doc.as<JsonObject>());
+    doc["timestamp"] = millis();
+    
+    sendJSON(doc);
+}
+
+void UARTComm::addLEDStats(JsonObject stats) {
+    const LEDFrameStats& frameStats = ledController.getFrameStats();
+    
+    JsonArray buckets = stats.createNestedArray("bucket_us");
+    for (int i = 0; i < LED_STATS_BUCKETS - 1; i++) {
+        buckets.add(LED_STATS_BUCKET_US[i]);
+    }
+    addHistogram(stats, "render", frameStats.render);
+    addHistogram(stats, "show", frameStats.show);
+    addHistogram(stats, "interval", frameStats.interval);
+    addHistogram(stats, "late", frameStats.late);
+    stats["missed"] = frameStats.missed;
+}
+
+void UARTComm::addHistogram(JsonObject stats, const char* name, const TimingHistogram& histogram) {
+    JsonObject entry = stats.createNestedObject(name);
+    JsonArray counts = entry.createNestedArray("counts");
+    for (int i = 0; i < LED_STATS_BUCKETS; i++) {
+        counts.add(histogram.counts[i]);
+    }
+    entry["avg_us"] = histogramAverage(histogram);
+    entry["max_us"] = histogram.maxUs;
+}
+
+void UARTComm::sendError(const char* format, ...) {
+    // Formatted on the stack - no String temporaries on the message path
+    char errorMsg[ERROR_MESSAGE_MAX];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(errorMsg, sizeof(errorMsg), format, args);
+    va_end(args);
+    
+    JsonDocument& doc = beginMessage(MSG_TYPE_ERROR);
     doc["device_id"] = DEVICE_ID;
     doc["error"] = errorMsg;
     doc["timestamp"] = millis();
@@ -189,20 +717,33 @@ void UARTComm::sendError(const String& errorMsg) {
 }
 
 void UARTComm::sendEncoderUpdate(int encoderId, float value, int direction) {
-    DynamicJsonDocument doc(256);
-    doc["type"] = MSG_TYPE_ENCODER;
+    // Only the latest value per encoder waits in the queue
+    uint16_t key = TX_KEY_ENCODER + encoderId;
+    if (binaryFraming) {
+        txQueue.begin(key);
+        BinaryFrameWriter<UARTTxQueue> frame(txQueue);
+        frame.begin(BIN_MSG_ENCODER);
+        frame.put((uint8_t)encoderId);
+        frame.put16((uint16_t)(constrain(value, 0.0f, 1.0f) * 65535));
+        frame.put((uint8_t)(int8_t)direction);
+        frame.put16((uint16_t)millis());
+        frame.end();
+        commitMessage();
+        return;
+    }
+    
+    JsonDocument& doc = beginMessage(MSG_TYPE_ENCODER);
     doc["device_id"] = DEVICE_ID;
     doc["encoder_id"] = encoderId;
     doc["value"] = value;
     doc["direction"] = direction;
     doc["timestamp"] = millis();
     
-    sendJSON(doc);
+    sendJSON(doc, key);
 }
 
 void UARTComm::sendI2CScanResult(int address, bool found) {
-    DynamicJsonDocument doc(256);
-    doc["type"] = MSG_TYPE_I2C_SCAN;
+    JsonDocument& doc = beginMessage(MSG_TYPE_I2C_SCAN);
     doc["device_id"] = DEVICE_ID;
     doc["address"] = address;
     doc["found"] = found;
@@ -211,6 +752,98 @@ void UARTComm::sendI2CScanResult(int address, bool found) {
     sendJSON(doc);
 }
 
+void UARTComm::sendDiagnosticStatus() {
+    JsonDocument& doc = beginMessage(MSG_TYPE_DIAGNOSTIC);
+    doc["device_id"] = DEVICE_ID;
+    doc["task"] = ledController.getDiagnosticName();
+    doc["running"] = ledController.isDiagnosticRunning();
+    doc["progress"] = ledController.getDiagnosticProgress();
+    doc["step"] = ledController.getDiagnosticStep();
+    doc["total_steps"] = ledController.getDiagnosticTotalSteps();
+    doc["timestamp"] = millis();
+    
+    sendJSON(doc);
+}
+
+void UARTComm::sendStreamAck(const StreamAck& ack) {
+    // Kept small - one is sent for every streamed frame that reaches the strip
+    // Never coalesced - a replaced ack could carry a resync request
+    if (binaryFraming) {
+        txQueue.begin(TX_KEY_NONE);
+        BinaryFrameWriter<UARTTxQueue> frame(txQueue);
+        frame.begin(BIN_MSG_STREAM_ACK);
+        frame.put32(ack.seq);
+        frame.put((uint8_t)constrain(ack.credits, 0, 255));
+        frame.put(ack.resync ? 0x01 : 0x00);
+        frame.put32(ack.dropped);
+        frame.end();
+        commitMessage();
+        return;
+    }
+    
+    JsonDocument& doc = beginMessage(MSG_TYPE_STREAM_ACK);
+    doc["seq"] = ack.seq;
+    doc["credits"] = ack.credits;
+    if (ack.resync) doc["resync"] = true;
+    if (ack.dropped) doc["dropped"] = ack.dropped;
+    
+    sendJSON(doc);
+}
+
+bool UARTComm::sendLog(uint8_t level, const char* tag, const char* text, size_t length) {
+    // Log lines only take the first part of the queue, so a burst of them
+    // cannot crowd out protocol messages. The queue is not thread safe, so
+    // lines logged from other tasks are dropped too, and so are lines logged
+    // while another message is open in the queue - begin() would restart it.
+    if (txQueue.getBytes() >= UART_TX_LOG_LIMIT || xTaskGetCurrentTaskHandle() != loopTask ||
+        txQueue.isBuilding()) {
+        logDropped++;
+        return false;
+    }
+    
+    // Built outside txDoc/txBuffer, so a line logged while a message is
+    // being composed there (before its begin()) leaves it intact
+    if (binaryFraming) {
+        size_t tagLength = strlen(tag);
+        txQueue.begin(TX_KEY_NONE);
+        BinaryFrameWriter<UARTTxQueue> frame(txQueue);
+        frame.begin(BIN_MSG_LOG);
+        frame.put(level);
+        frame.put((uint8_t)tagLength);
+        frame.put((const uint8_t*)tag, tagLength);
+        frame.put((const uint8_t*)text, length);
+        frame.end();
+        return commitLogLine();
+    }
+    
+    StaticJsonDocument<128> doc;
+    doc["type"] = MSG_TYPE_LOG;
+    doc["level"] = Logger::levelName(level);
+    doc["tag"] = tag;
+    doc["msg"] = text;
+    
+    // Escaped control characters take 6 bytes each, so a line can outgrow
+    // the buffer - drop it rather than send half a JSON object
+    char line[LOG_LINE_MAX * 2 + 64];
+    size_t lineLength = serializeJson(doc, line, sizeof(line) - 2);
+    if (doc.overflowed() || lineLength != measureJson(doc)) {
+        logDropped++;
+        return false;
+    }
+    line[lineLength++] = '\r';
+    line[lineLength++] = '\n';
+    txQueue.begin(TX_KEY_NONE);
+    txQueue.write((const uint8_t*)line, lineLength);
+    return commitLogLine();
+}
+
+bool UARTComm::commitLogLine() {
+    // A full queue drops the line (counted by the queue as well)
+    if (txQueue.commit()) return true;
+    logDropped++;
+    return false;
+}
+
 bool UARTComm::shouldSendHeartbeat() {
     return (millis() - lastHeartbeat) >= HEARTBEAT_INTERVAL_MS;
 }
@@ -219,12 +852,6 @@ bool UARTComm::shouldSendStatus() {
     return (millis() - lastStatusUpdate) >= STATUS_UPDATE_INTERVAL_MS;
 }
 
-void UARTComm::debugPrint(const String& message) {
-    if (DEBUG_SERIAL) {
-        Serial.println("[DEBUG] " + message);
-    }
-}
-
 void UARTComm::incrementErrorCount() {
     errors++;
 } 
\ No newline at end of file
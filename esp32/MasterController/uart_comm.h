@@ -3,16 +3,44 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include "config.h"
+#include "led_controller.h"
+#include "uart_framer.h"
+#include "uart_binary.h"
+#include "uart_tx_queue.h"
 
 // ============================================================================
 // UART Communication Manager
-// Handles JSON messaging between ESP32 and Raspberry Pi
+// Handles JSON messaging between ESP32 and Raspberry Pi, or binary frames
+// (uart_binary.h) once the Pi asks for them with a "protocol" message
+//
+// Steady-state messaging does not touch the heap: one receive and one
+// transmit document are allocated at startup and reused, and outgoing lines
+// are serialized into a fixed scratch buffer. Every JSON document allocation
+// goes through JsonHeapAllocator, so any document that ends up on the heap
+// per message shows up as a growing json_heap_allocs in status.
+//
+// Nothing is written to Serial directly: every message goes through a
+// bounded transmit queue (uart_tx_queue.h) that update() drains only as far
+// as the UART has room, so a full TX FIFO never blocks a sender.
 // ============================================================================
 
+struct JsonHeapAllocator {
+    void* allocate(size_t size);
+    void deallocate(void* pointer);
+    void* reallocate(void* pointer, size_t size);
+    
+    static unsigned long allocations;
+};
+
+typedef BasicJsonDocument<JsonHeapAllocator> CountedJsonDocument;
+typedef TxQueue<UART_TX_QUEUE_BYTES, UART_TX_QUEUE_ENTRIES> UARTTxQueue;
+
 class UARTComm {
 private:
-    String inputBuffer;
+    LineFramer<UART_BUFFER_SIZE> rxFramer;  // Incoming bytes, split into lines in place
     unsigned long lastHeartbeat;
     unsigned long lastStatusUpdate;
     bool isConnected;
@@ -21,8 +49,29 @@ private:
     unsigned long messagesSent;
     unsigned long messagesReceived;
     unsigned long errors;
+    
+    // Decoded led_stream payload
+    uint8_t streamBytes[LED_STREAM_MAX_BYTES];
+    
+    // Reused JSON documents and the outgoing line buffer
+    CountedJsonDocument rxDoc;
+    CountedJsonDocument txDoc;
+    char txBuffer[JSON_TX_BUFFER_SIZE];
+    unsigned long txDropped;     // Outgoing messages too large for txDoc/txBuffer
+    
+    // Binary framing - both directions switch together
+    bool binaryFraming;
+    uint8_t rxFrame[UART_BUFFER_SIZE];  // Decoded incoming frame
+    unsigned long crcErrors;     // Binary frames dropped as malformed
+    
+    // Outgoing messages waiting for room in the UART
+    UARTTxQueue txQueue;
+    TaskHandle_t loopTask;       // The only task allowed to queue messages
+    unsigned long logDropped;    // Log lines refused (queue too full, other task, message open)
 
 public:
+    UARTComm();
+    
     // Initialization
     void begin();
     
@@ -30,36 +79,76 @@ public:
     void update();
     
     // Message sending
-    void sendMessage(const String& message);
-    void sendJSON(DynamicJsonDocument& doc);
+    void sendMessage(const char* message);
+    void sendJSON(JsonDocument& doc, uint16_t key = TX_KEY_NONE); // key: replaces a queued message with the same key
+    JsonDocument& beginMessage(const char* type); // Cleared txDoc with "type" set
     void sendStartup();
     void sendHeartbeat();
     void sendStatus();
-    void sendError(const String& errorMsg);
+    void sendError(const char* format, ...) __attribute__((format(printf, 2, 3)));
     void sendEncoderUpdate(int encoderId, float value, int direction);
     void sendI2CScanResult(int address, bool found);
+    void sendDiagnosticStatus();
+    void sendStreamAck(const StreamAck& ack);
+    void sendLEDStats();
+    bool sendLog(uint8_t level, const char* tag, const char* text, size_t length); // Logger sink, false if dropped
     
     // Connection status
     bool getConnectionStatus() const { return isConnected; }
+    bool isBinaryFraming() const { return binaryFraming; }
     
     // Statistics
     unsigned long getMessagesSent() const { return messagesSent; }
     unsigned long getMessagesReceived() const { return messagesReceived; }
     unsigned long getErrors() const { return errors; }
+    unsigned long getRxOverflows() const { return rxFramer.getOverflows(); }
+    unsigned long getCrcErrors() const { return crcErrors; }
+    size_t getTxQueueDepth() const { return txQueue.getDepth(); }
+    unsigned long getTxQueueDrops() const { return txQueue.getDrops(); }
+    unsigned long getTxCoalesced() const { return txQueue.getCoalesced(); }
+    unsigned long getJsonHeapAllocations() const { return JsonHeapAllocator::allocations; }
 
 private:
     // Message processing
     void processIncomingData();
-    void processMessage(const String& message);
-    void handleLEDUpdate(DynamicJsonDocument& doc);
-    void handleSystemCommand(DynamicJsonDocument& doc);
+    void processMessage(const char* message, size_t length);
+    void processFrame(const char* frame, size_t length);
+    void handleProtocol(JsonDocument& doc);
+    void setBinaryFraming(bool enable);
+    void handleLEDUpdate(JsonDocument& doc);
+    void handleLEDBatch(JsonDocument& doc);
+    bool parseLEDUpdate(JsonVariant src, LEDRingUpdate& update);
+    LEDPattern parsePattern(const char* patternStr);
+    void handleLEDProgram(JsonDocument& doc);
+    void handleLEDProgramCommand(JsonDocument& doc);
+    bool parseKeyframe(JsonVariant src, ProgramKeyframe& keyframe);
+    ProgramEasing parseEasing(const char* easingStr);
+    void handleLEDStream(JsonDocument& doc);
+    void handleLEDMeter(JsonDocument& doc);
+    void handleLEDOverlay(JsonDocument& doc);
+    void handleSystemCommand(JsonDocument& doc);
+    
+    // Packed forms of the hot Pi -> ESP32 messages
+    void handleBinaryLEDUpdate(const uint8_t* payload, size_t length);
+    void handleBinaryLEDBatch(const uint8_t* payload, size_t length);
+    void handleBinaryLEDMeter(const uint8_t* payload, size_t length);
+    void handleBinaryLEDStream(const uint8_t* payload, size_t length);
+    void unpackLEDUpdate(const uint8_t* src, LEDRingUpdate& update);
     
     // Timing checks
     bool shouldSendHeartbeat();
     bool shouldSendStatus();
     
+    // LED frame timing histograms (led_stats.h)
+    void addLEDStats(JsonObject stats);
+    void addHistogram(JsonObject stats, const char* name, const TimingHistogram& histogram);
+    
+    // Transmit queue
+    void commitMessage();
+    bool commitLogLine();
+    void drainTransmitQueue();
+    
     // Utilities
-    void debugPrint(const String& message);
     void incrementErrorCount();
 };
 
@@ -68,6 +157,12 @@ extern UARTComm uart;
 
 // Callback function declarations (implemented in main .ino file)
 extern void onLEDUpdateReceived(int encoderId, uint8_t r, uint8_t g, uint8_t b, LEDPattern pattern, float value);
-extern void onSystemCommandReceived(const String& command, const String& parameter);
+extern void onLEDBatchReceived(const LEDRingUpdate* updates, int count);
+extern void onLEDProgramReceived(int encoderId, const LEDProgram& program, bool start);
+extern void onLEDProgramCommand(int encoderId, const char* command, const ProgramKeyframe& target);
+extern void onLEDStreamReceived(int target, uint32_t seq, bool keyFrame, const uint8_t* ops, size_t length);
+extern void onLEDMeterReceived(int firstEncoder, const uint8_t* levels, int count);
+extern void onLEDOverlayReceived(int encoderId, int slot, const LEDOverlay& overlay);
+extern void onSystemCommandReceived(const char* command, const char* parameter);
 
 #endif // UART_COMM_H 
\ No newline at end of file
@@ -0,0 +1,120 @@
+#ifndef UART_FRAMER_H
+#define UART_FRAMER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// ============================================================================
+// UART Line Framer
+// Fixed-size receive buffer that splits the byte stream into '\n'-terminated
+// lines without heap allocation or per-byte copies. Bytes are read into it in
+// bulk; complete lines are returned as pointer/length views into the buffer.
+//
+// The buffer works as a ring that never lets a line wrap: when the write
+// position reaches the end, the unfinished line (at most one) is moved back
+// to the front, so every line is contiguous. A line that fills the whole
+// buffer is dropped up to its delimiter - whatever follows the delimiter is
+// kept, so the next message survives. The delimiter can be switched to 0x00
+// for binary frames (uart_binary.h). Header-only and free of Arduino
+// dependencies (see bench/uart_framer_bench.cpp).
+// ============================================================================
+
+template <size_t Capacity>
+class LineFramer {
+public:
+    LineFramer() { reset(); }
+    
+    void reset() {
+        head = 0;
+        tail = 0;
+        scan = 0;
+        discarding = false;
+        overflows = 0;
+        delimiter = '\n';
+    }
+    
+    // Bytes already received but not yet returned are split on the new
+    // delimiter from here on
+    void setDelimiter(char value) {
+        delimiter = value;
+        scan = head;
+    }
+    
+    // Contiguous free space for the next read, then commit() what was
+    // written. Invalidates earlier line views.
+    char* writeBuffer(size_t& space) {
+        makeRoom();
+        space = Capacity - tail;
+        return buffer + tail;
+    }
+    void commit(size_t count) { tail += count; }
+    
+    // Next complete line without its "\n" / "\r\n" (or 0x00). The view stays
+    // valid until the next writeBuffer() call. Empty lines are skipped.
+    bool nextLine(const char*& line, size_t& length) {
+        while (scan < tail) {
+            const char* newline = (const char*)memchr(buffer + scan, delimiter, tail - scan);
+            if (newline == nullptr) {
+                scan = tail;
+                break;
+            }
+            
+            size_t start = head;
+            size_t end = newline - buffer;
+            head = end + 1;
+            scan = head;
+            
+            // Tail end of an oversized line
+            if (discarding) {
+                discarding = false;
+                continue;
+            }
+            
+            length = end - start;
+            if (delimiter == '\n' && length > 0 && buffer[start + length - 1] == '\r') length--;
+            if (length == 0) continue;
+            
+            line = buffer + start;
+            return true;
+        }
+        
+        // One line filled the buffer - drop it and resync at its delimiter
+        if (head == 0 && tail == Capacity) {
+            if (!discarding) overflows++;
+            discarding = true;
+            tail = 0;
+            scan = 0;
+        }
+        return false;
+    }
+    
+    size_t getPending() const { return tail - head; }
+    unsigned long getOverflows() const { return overflows; }
+
+private:
+    void makeRoom() {
+        if (head == 0) return;
+        
+        // Nothing pending - start over at the front for free; otherwise
+        // only move the unfinished line once the end is reached
+        if (head == tail) {
+            head = tail = scan = 0;
+        } else if (tail == Capacity) {
+            memmove(buffer, buffer + head, tail - head);
+            tail -= head;
+            scan -= head;
+            head = 0;
+        }
+    }
+    
+    char buffer[Capacity];
+    size_t head;             // Start of the first unconsumed line
+    size_t tail;             // End of received data
+    size_t scan;             // Searched for the delimiter up to here
+    bool discarding;         // Dropping the rest of an oversized line
+    unsigned long overflows;
+    char delimiter;          // '\n' for JSON lines, 0x00 for binary frames
+};
+
+#endif // UART_FRAMER_H
@@ -0,0 +1,222 @@
+#ifndef UART_TX_QUEUE_H
+#define UART_TX_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// ============================================================================
+// UART Transmit Queue
+// Bounded FIFO of outgoing messages, already serialized (JSON line or binary
+// frame), drained into the UART only as far as its TX buffer has room - so
+// sending never stalls the main loop. Header-only and free of Arduino
+// dependencies (see bench/uart_tx_queue_bench.cpp).
+//
+// Messages are stored back to back in a byte ring and may wrap. A message
+// is built with begin() / write() / commit(); if it does not fit it is
+// dropped whole. A message with a non-zero key retires a pending message
+// with the same key (e.g. the latest value per encoder) once it is stored,
+// unless that one is already partly on the wire - a replacement that does
+// not fit leaves the old value queued. Retired messages are skipped when
+// the drain reaches them, or squeezed out early if the queue runs out of
+// room.
+//
+// Single producer and consumer - only used from the main loop. Only one
+// message is built at a time: begin() restarts whatever is open, so a
+// producer that can run in the middle of another (the log sink) checks
+// isBuilding() first.
+// ============================================================================
+
+#define TX_KEY_NONE 0
+
+template <size_t Capacity, size_t MaxEntries>
+class TxQueue {
+    static_assert(Capacity <= 65535, "TxQueue entries store 16-bit offsets");
+
+public:
+    TxQueue() { reset(); }
+
+    void reset() {
+        head = 0;
+        used = 0;
+        firstEntry = 0;
+        entryCount = 0;
+        pending = 0;
+        sentOffset = 0;
+        building = false;
+        buildLength = 0;
+        buildOverflow = false;
+        maxPending = 0;
+        drops = 0;
+        coalesced = 0;
+    }
+
+    // Start a message. key TX_KEY_NONE never coalesces.
+    void begin(uint16_t key) {
+        building = true;
+        buildKey = key;
+        buildLength = 0;
+        buildOverflow = false;
+    }
+
+    // Append to the message being built (also the sink for BinaryFrameWriter)
+    size_t write(const uint8_t* data, size_t length) {
+        if (!building || buildOverflow) return 0;
+        if (used + buildLength + length > Capacity && pending < entryCount) compact();
+        if (used + buildLength + length > Capacity) {
+            buildOverflow = true;
+            return 0;
+        }
+
+        size_t pos = (head + used + buildLength) % Capacity;
+        size_t first = length < Capacity - pos ? length : Capacity - pos;
+        memcpy(buffer + pos, data, first);
+        memcpy(buffer, data + first, length - first);
+        buildLength += length;
+        return length;
+    }
+
+    // Queue the message. False if it did not fit - it is dropped whole and
+    // any message it would have replaced stays queued.
+    bool commit() {
+        building = false;
+        if (buildOverflow || buildLength == 0) {
+            drops++;
+            return false;
+        }
+
+        // The bytes are stored, so the message it replaces can go - which
+        // also frees its entry for this one
+        if (buildKey != TX_KEY_NONE) retire(buildKey);
+        if (entryCount == MaxEntries && pending < entryCount) compact();
+        if (entryCount == MaxEntries) {
+            drops++;
+            return false;
+        }
+
+        Entry& entry = entries[(firstEntry + entryCount) % MaxEntries];
+        entry.length = (uint16_t)buildLength;
+        entry.key = buildKey;
+        entry.live = true;
+        entryCount++;
+        used += buildLength;
+        pending++;
+        if (pending > maxPending) maxPending = pending;
+        return true;
+    }
+
+    // Hand up to budget bytes to sink.write() (returns what it accepted).
+    // Returns the bytes written.
+    template <typename Sink>
+    size_t drain(Sink& sink, size_t budget) {
+        size_t sent = 0;
+
+        while (entryCount > 0) {
+            Entry& entry = entries[firstEntry];
+            if (!entry.live) {
+                pop();
+                continue;
+            }
+            if (sent >= budget) break;
+
+            size_t pos = (head + sentOffset) % Capacity;
+            size_t chunk = entry.length - sentOffset;
+            if (chunk > Capacity - pos) chunk = Capacity - pos;
+            if (chunk > budget - sent) chunk = budget - sent;
+
+            size_t written = sink.write(buffer + pos, chunk);
+            sentOffset += written;
+            sent += written;
+            if (written < chunk) break;
+
+            if (sentOffset == entry.length) {
+                pending--;
+                pop();
+            }
+        }
+
+        return sent;
+    }
+
+    bool isBuilding() const { return building; }      // Between begin() and commit()
+    size_t getDepth() const { return pending; }       // Messages waiting (not replaced)
+    size_t getMaxDepth() const { return maxPending; }
+    size_t getBytes() const { return used; }
+    unsigned long getDrops() const { return drops; }
+    unsigned long getCoalesced() const { return coalesced; }
+
+private:
+    struct Entry {
+        uint16_t length;
+        uint16_t key;
+        bool live;           // false once replaced by a newer message
+    };
+
+    // Mark pending messages with this key replaced
+    void retire(uint16_t key) {
+        for (size_t i = 0; i < entryCount; i++) {
+            Entry& entry = entries[(firstEntry + i) % MaxEntries];
+            if (!entry.live || entry.key != key) continue;
+            if (i == 0 && sentOffset > 0) continue;  // Already going out
+            entry.live = false;
+            pending--;
+            coalesced++;
+        }
+    }
+
+    void pop() {
+        Entry& entry = entries[firstEntry];
+        head = (head + entry.length) % Capacity;
+        used -= entry.length;
+        firstEntry = (firstEntry + 1) % MaxEntries;
+        entryCount--;
+        sentOffset = 0;
+    }
+
+    // Close the gaps left by replaced messages, moving the message being
+    // built along. Only runs when the queue is short of room.
+    void compact() {
+        size_t from = 0, to = 0, kept = 0;
+        for (size_t i = 0; i < entryCount; i++) {
+            Entry entry = entries[(firstEntry + i) % MaxEntries];
+            if (entry.live) {
+                move(to, from, entry.length);
+                entries[(firstEntry + kept) % MaxEntries] = entry;
+                to += entry.length;
+                kept++;
+            }
+            from += entry.length;
+        }
+        move(to, from, buildLength);
+        used = to;
+        entryCount = kept;
+    }
+
+    // Offsets from head; to <= from, so copying forward is safe
+    void move(size_t to, size_t from, size_t length) {
+        if (to == from) return;
+        for (size_t i = 0; i < length; i++) {
+            buffer[(head + to + i) % Capacity] = buffer[(head + from + i) % Capacity];
+        }
+    }
+
+    uint8_t buffer[Capacity];
+    Entry entries[MaxEntries];
+    size_t head;             // First byte of the oldest message
+    size_t used;             // Bytes held by queued messages
+    size_t firstEntry;
+    size_t entryCount;       // Queued messages incl. replaced ones
+    size_t pending;          // Queued messages still to be sent
+    size_t sentOffset;       // Bytes of the oldest message already written
+
+    bool building;
+    uint16_t buildKey;
+    size_t buildLength;
+    bool buildOverflow;
+
+    size_t maxPending;
+    unsigned long drops;
+    unsigned long coalesced;
+};
+
+#endif // UART_TX_QUEUE_H